@@ -2,5 +2,6 @@
 
 set -e
 cd build
-make -j2 liblw-tests
+make -j2 liblw-tests liblw-allocation-tests
 Default/liblw-tests
+Default/liblw-allocation-tests
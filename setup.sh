@@ -1,7 +1,9 @@
 #! /bin/bash
 
 gypGenerator=
+cxxStandard=
 ENABLE_COVERAGE=${ENABLE_COVERAGE:=false}
+ENABLE_EVENT_STATS=${ENABLE_EVENT_STATS:=false}
 
 # Load command-line arguments.
 while [ "$1" != "" ]; do
@@ -12,8 +14,17 @@ while [ "$1" != "" ]; do
             ;;
 
         --coverage )
-            shift
             ENABLE_COVERAGE=true
+            ;;
+
+        --event-stats )
+            ENABLE_EVENT_STATS=true
+            ;;
+
+        --std )
+            shift
+            cxxStandard=$1
+            ;;
     esac
     shift
 done
@@ -42,5 +53,13 @@ if $ENABLE_COVERAGE; then
     gypArgs="$gypArgs -D coverage=1"
 fi
 
+if $ENABLE_EVENT_STATS; then
+    gypArgs="$gypArgs -D event_stats=1"
+fi
+
+if [ "$cxxStandard" != "" ]; then
+    gypArgs="$gypArgs -D cxx_std=$cxxStandard"
+fi
+
 # And then run gyp
 run_gyp $gypArgs
@@ -10,6 +10,11 @@ Application::Application(void):
     Singleton<Application>()
 {}
 
+Application::Application(ThreadLocal tag):
+    Loop(),
+    Singleton<Application>(tag)
+{}
+
 Application::~Application(void){}
 
 }
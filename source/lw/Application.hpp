@@ -5,10 +5,22 @@
 
 namespace lw {
 
+class LoopGroup;
+
+/// @brief The application's event loop.
+///
+/// `Application::instance()` gives the process-wide application, except on the
+/// threads of a `LoopGroup` where it gives that thread's own application.
 class Application : public event::Loop, public Singleton<Application>{
 public:
     Application(void);
     ~Application(void);
+
+private:
+    friend class LoopGroup;
+
+    /// @brief Constructs the application for the calling thread only.
+    explicit Application(ThreadLocal tag);
 };
 
 }
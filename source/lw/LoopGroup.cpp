@@ -0,0 +1,125 @@
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+#ifdef __linux__
+#   include <pthread.h>
+#   include <sched.h>
+#endif
+
+#include "lw/LoopGroup.hpp"
+
+namespace lw {
+
+namespace {
+    /// @brief Pins the calling thread to a single CPU, where supported.
+    void pin_thread(const std::size_t index){
+#ifdef __linux__
+        const std::size_t cpus = std::thread::hardware_concurrency();
+        if (cpus == 0) {
+            return;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)index;
+#endif
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+LoopGroup::LoopGroup(const Options& options):
+    m_placement(options.m_placement),
+    m_next(0),
+    m_stopped(false),
+    m_posting(0)
+{
+    const std::size_t threads = options.m_threads == 0 ? 1 : options.m_threads;
+    m_workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_workers.emplace_back(new _Worker());
+    }
+
+    // Each thread hands back its application once it exists, so work can be posted as soon as the
+    // constructor returns.
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::size_t started = 0;
+    for (std::size_t i = 0; i < threads; ++i) {
+        _Worker* worker = m_workers[i].get();
+        worker->thread = std::thread([&, worker, i](){
+            if (options.m_pin_threads) {
+                pin_thread(i);
+            }
+
+            Application application{Application::ThreadLocal()};
+            application._add_keep_alive();
+            {
+                // Notify under the lock, the constructor may return and destroy `ready` as soon as
+                // the lock is released.
+                std::lock_guard<std::mutex> lock(mutex);
+                worker->application = &application;
+                ++started;
+                ready.notify_one();
+            }
+
+            application.run();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.wait(lock, [&](){ return started == threads; });
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+LoopGroup::~LoopGroup(void){
+    stop();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+std::size_t LoopGroup::choose(const Placement placement){
+    if (placement == Placement::ROUND_ROBIN) {
+        return m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    }
+
+    std::size_t chosen = 0;
+    std::size_t least = std::numeric_limits<std::size_t>::max();
+    for (std::size_t i = 0; i < m_workers.size(); ++i) {
+        const std::size_t pending = m_workers[i]->pending.load(std::memory_order_relaxed);
+        if (pending < least) {
+            chosen = i;
+            least = pending;
+        }
+    }
+    return chosen;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void LoopGroup::stop(void){
+    if (m_stopped.exchange(true)) {
+        return;
+    }
+
+    // Posts which got past the check before the flag was set finish first. Any later ones see the
+    // flag, so once this reaches zero nothing else will touch the applications.
+    while (m_posting.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    for (auto& worker : m_workers) {
+        worker->application->_release_keep_alive();
+    }
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+        worker->application = nullptr;
+    }
+}
+
+}
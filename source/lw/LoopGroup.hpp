@@ -0,0 +1,226 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lw/Application.hpp"
+#include "lw/error/Exception.hpp"
+
+namespace lw {
+
+LW_DEFINE_EXCEPTION(LoopGroupError);
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Runs a group of event loops, each on its own thread.
+///
+/// Every thread gets its own `Application`, so `Application::instance()` and the helpers built on
+/// it use the thread's own loop. Work is handed to the group with `post`, which places it on one of
+/// the loops either in turn or on whichever has the least work waiting. The loops keep running
+/// until the group is stopped or destroyed, after which they finish their remaining work and exit.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::LoopGroup group(lw::LoopGroup::Options().pin_threads(true));
+///     for (auto& connection : connections) {
+///         group.post([connection](){
+///             // Runs on one of the group's threads, with its own Application.
+///         });
+///     }
+/// @endcode
+class LoopGroup {
+public:
+    /// @brief How work is placed on the group's loops.
+    enum class Placement {
+        ROUND_ROBIN,    ///< Each loop in turn.
+        LEAST_LOADED    ///< The loop with the fewest posted tasks waiting to run.
+    };
+
+    /// @brief Settings for a `LoopGroup`.
+    class Options {
+    public:
+        Options(void):
+            m_threads(std::thread::hardware_concurrency()),
+            m_pin_threads(false),
+            m_placement(Placement::ROUND_ROBIN)
+        {}
+
+        /// @brief Sets the number of threads, defaulting to the number of hardware threads.
+        Options& threads(const std::size_t threads){
+            m_threads = threads;
+            return *this;
+        }
+
+        /// @brief Sets whether to pin each thread to a CPU, which is off by default.
+        ///
+        /// Thread `i` is pinned to CPU `i` modulo the number of CPUs. Pinning is only supported
+        /// on Linux and is ignored elsewhere.
+        Options& pin_threads(const bool pin){
+            m_pin_threads = pin;
+            return *this;
+        }
+
+        /// @brief Sets how `post` places work when not told otherwise.
+        Options& placement(const Placement placement){
+            m_placement = placement;
+            return *this;
+        }
+
+    private:
+        friend class LoopGroup;
+
+        std::size_t m_threads;  ///< The number of threads to start.
+        bool m_pin_threads;     ///< Flag indicating threads should be pinned to CPUs.
+        Placement m_placement;  ///< The default placement for work.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Starts the threads and waits for their loops to be ready.
+    ///
+    /// @param options The group's settings.
+    explicit LoopGroup(const Options& options = Options());
+
+    LoopGroup(const LoopGroup&) = delete;
+    LoopGroup& operator=(const LoopGroup&) = delete;
+
+    /// @brief Stops the group, waiting for the threads to exit.
+    ~LoopGroup(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of loops in the group.
+    std::size_t size(void) const {
+        return m_workers.size();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Gives access to one of the group's applications.
+    ///
+    /// The application is destroyed when the group is stopped, so the reference must not be used
+    /// after `stop` has been called.
+    ///
+    /// @throws LoopGroupError If the group has been stopped.
+    ///
+    /// @param index The index of the loop, less than `size()`.
+    Application& application(const std::size_t index){
+        _check_running();
+        return *m_workers[index]->application;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Picks the loop to place work on.
+    ///
+    /// @param placement How to choose the loop.
+    ///
+    /// @return The index of the chosen loop.
+    std::size_t choose(const Placement placement);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls a functor on one of the group's threads.
+    ///
+    /// This may be called from any thread, including the group's own, until the group is stopped.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func The functor to call.
+    template<typename Func>
+    void post(Func&& func){
+        post(std::forward<Func>(func), m_placement);
+    }
+
+    /// @brief Calls a functor on one of the group's threads, chosen as given.
+    template<typename Func>
+    void post(Func&& func, const Placement placement){
+        post_to(choose(placement), std::forward<Func>(func));
+    }
+
+    /// @brief Calls a functor on a specific thread of the group.
+    ///
+    /// @throws LoopGroupError If the group has been stopped.
+    ///
+    /// @param index The index of the loop to run the functor on.
+    /// @param func  The functor to call.
+    template<typename Func>
+    void post_to(const std::size_t index, Func&& func){
+        // `stop` waits for posts in flight before letting the loops go, so the application is not
+        // destroyed while this is using it.
+        _Posting posting(*this);
+        _check_running();
+        _Worker& worker = *m_workers[index];
+        worker.pending.fetch_add(1, std::memory_order_relaxed);
+        worker.application->post(
+            [&worker, func = std::forward<Func>(func)]() mutable {
+                worker.pending.fetch_sub(1, std::memory_order_relaxed);
+                func();
+            }
+        );
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Lets the loops exit once their work is done and waits for the threads to end.
+    ///
+    /// This may be called from any thread but the group's own, and only the first call has any
+    /// effect. Posting to the group afterwards throws a `LoopGroupError`.
+    void stop(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    /// @brief One thread of the group and its loop.
+    struct _Worker {
+        _Worker(void):
+            application(nullptr),
+            pending(0)
+        {}
+
+        std::thread thread;                 ///< The thread running the loop.
+        Application* application;           ///< The thread's application.
+        std::atomic<std::size_t> pending;   ///< Posted tasks which have not run yet.
+    };
+
+    /// @brief Counts a post in flight for as long as it is in scope.
+    struct _Posting {
+        explicit _Posting(LoopGroup& group):
+            group(group)
+        {
+            group.m_posting.fetch_add(1);
+        }
+
+        ~_Posting(void){
+            group.m_posting.fetch_sub(1);
+        }
+
+        LoopGroup& group;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs the loop for one worker.
+    void _run(_Worker& worker, const std::size_t index);
+
+    /// @brief Throws a `LoopGroupError` if the group has been stopped.
+    void _check_running(void) const {
+        if (m_stopped.load()) {
+            throw LoopGroupError(1, "The loop group has been stopped.");
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    std::vector<std::unique_ptr<_Worker>> m_workers;    ///< The group's threads.
+    Placement m_placement;                              ///< The default placement for work.
+    std::atomic<std::size_t> m_next;                    ///< The next loop for round robin.
+    std::atomic<bool> m_stopped;                        ///< Flag indicating `stop` was called.
+    std::atomic<std::size_t> m_posting;                 ///< Posts which may use an application.
+};
+
+}
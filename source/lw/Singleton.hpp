@@ -7,38 +7,75 @@ namespace lw {
 
 /// @brief Base class for singletons.
 ///
+/// A thread may also have its own instance, which takes precedence over the
+/// process-wide one for code running on that thread.
+///
 /// @tparam T The type to have only a single instance.
 template< class T >
 class Singleton {
 public:
     static bool exists( void ){
-        return s_instance != nullptr;
+        return instance_ptr() != nullptr;
     }
 
     static T* instance_ptr( void ){
-        return s_instance;
+        T* thread_instance = _thread_instance();
+        return thread_instance ? thread_instance : s_instance;
     }
 
     static T& instance( void ){
         return *instance_ptr();
     }
 
-    Singleton( void ){
+    Singleton( void ):
+        m_thread_local( false )
+    {
         s_instance = (T*)this;
     }
 
     Singleton( const Singleton& ) = delete;
 
-    Singleton( Singleton&& other ){
-        s_instance = (T*)this;
+    Singleton( Singleton&& other ):
+        m_thread_local( other.m_thread_local )
+    {
+        if( m_thread_local ){
+            _thread_instance() = (T*)this;
+        }
+        else {
+            s_instance = (T*)this;
+        }
     }
 
     ~Singleton( void ){
-        s_instance = nullptr;
+        if( !m_thread_local ){
+            s_instance = nullptr;
+        }
+        else if( _thread_instance() == (T*)this ){
+            _thread_instance() = nullptr;
+        }
+    }
+
+protected:
+    /// @brief Tag for constructing the calling thread's own instance.
+    struct ThreadLocal {};
+
+    /// @brief Registers this as the instance for the calling thread only.
+    explicit Singleton( ThreadLocal ):
+        m_thread_local( true )
+    {
+        _thread_instance() = (T*)this;
     }
 
 private:
+    /// @brief The calling thread's own instance, if it has one.
+    static T*& _thread_instance( void ){
+        static thread_local T* s_thread_instance = nullptr;
+        return s_thread_instance;
+    }
+
     static T* s_instance;
+
+    bool m_thread_local; ///< Flag indicating this is a thread's own instance.
 };
 
 }
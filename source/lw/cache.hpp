@@ -0,0 +1,3 @@
+#pragma once
+
+#include "lw/cache/AsyncCache.hpp"
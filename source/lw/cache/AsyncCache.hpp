@@ -0,0 +1,323 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "lw/error.hpp"
+#include "lw/event.hpp"
+
+namespace lw {
+namespace cache {
+
+/// @brief A cache of asynchronously loaded values, evicted by age and least recent use.
+///
+/// Looking up a key which is missing calls the given loader, and every other lookup of that key
+/// made while the loader is running shares its result instead of loading again. Loaded values
+/// expire a fixed time after they finish loading, which is enforced by a timer on the loop that
+/// does not keep the loop running on its own. Expired entries are also never returned. Once
+/// the cache holds `capacity` entries, adding another evicts the least recently used one. Failed
+/// loads are not cached.
+///
+/// Like the rest of `lw::event`, the cache must only be used from the thread running its loop.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::cache::AsyncCache<std::string, lw::memory::Buffer> files(loop, 128, 30s);
+///
+///     files.get(path, [&](){
+///         return lw::io::open(loop, path).then([](std::shared_ptr<lw::io::File>&& file){
+///             return file->read(4096);
+///         });
+///     }).then([](lw::memory::Buffer&& contents){
+///         // ...
+///     });
+/// @endcode
+///
+/// @tparam K     The key type.
+/// @tparam V     The value type, which must be copy constructible.
+/// @tparam Hash  The hash functor for keys.
+/// @tparam Equal The equality functor for keys.
+template<
+    typename K,
+    typename V,
+    typename Hash = std::hash<K>,
+    typename Equal = std::equal_to<K>
+>
+class AsyncCache {
+public:
+    /// @brief The clock used for expiring entries.
+    typedef std::chrono::steady_clock clock;
+
+    /// @brief The resolution of entry lifetimes.
+    typedef event::Timeout::resolution duration;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Constructs an empty cache.
+    ///
+    /// @param loop     The event loop whose timers expire entries.
+    /// @param capacity The most entries to hold, including ones still loading.
+    /// @param ttl      How long a loaded value stays in the cache.
+    AsyncCache(event::Loop& loop, const std::size_t capacity, const duration& ttl):
+        m_state(std::make_shared<_State>(loop, capacity, ttl))
+    {}
+
+    AsyncCache(const AsyncCache&) = delete;
+    AsyncCache& operator=(const AsyncCache&) = delete;
+
+    ~AsyncCache(void){
+        _disarm(*m_state);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Gets the value for the key, loading it if needed.
+    ///
+    /// @tparam Loader A functor with no parameters returning a `Future<V>`.
+    ///
+    /// @param key    The key to look up.
+    /// @param loader The functor to call if the key is not cached or being loaded.
+    ///
+    /// @return A future for a copy of the value.
+    template<typename Loader>
+    event::Future<V> get(const K& key, Loader&& loader){
+        _State& state = *m_state;
+        auto found = state.entries.find(key);
+        if (found != state.entries.end()) {
+            _Entry& entry = found->second;
+            if (!entry.loaded || clock::now() < entry.expires) {
+                state.lru.splice(state.lru.begin(), state.lru, entry.lru);
+                return _copy(entry.value);
+            }
+            _erase(state, found);
+        }
+
+        event::SharedFuture<V> value = loader().share();
+        const std::uint64_t id = ++state.next_id;
+        state.lru.push_front(key);
+        state.entries.emplace(key, _Entry(value, state.lru.begin(), id));
+        while (state.entries.size() > state.capacity) {
+            _erase(state, state.entries.find(state.lru.back()));
+        }
+
+        // This is the first continuation on the value, so the entry is updated before any of the
+        // callers' continuations run.
+        std::weak_ptr<_State> weak_state = m_state;
+        value.then([weak_state, key, id](const V&){
+            if (auto state = weak_state.lock()) {
+                _loaded(*state, key, id);
+            }
+        }, [weak_state, key, id](const error::Error&){
+            if (auto state = weak_state.lock()) {
+                _failed(*state, key, id);
+            }
+        });
+        return _copy(value);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if a loaded, unexpired value is cached for the key.
+    bool contains(const K& key) const {
+        auto found = m_state->entries.find(key);
+        return found != m_state->entries.end()
+            && found->second.loaded
+            && clock::now() < found->second.expires;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of entries, including ones still loading.
+    std::size_t size(void) const {
+        return m_state->entries.size();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Removes the key from the cache.
+    ///
+    /// Callers already waiting on a load for the key still receive its result.
+    void erase(const K& key){
+        auto found = m_state->entries.find(key);
+        if (found != m_state->entries.end()) {
+            _erase(*m_state, found);
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Removes every entry from the cache.
+    void clear(void){
+        _State& state = *m_state;
+        state.entries.clear();
+        state.lru.clear();
+        state.expiries.clear();
+        _disarm(state);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    typedef std::list<K> _LruList;
+
+    /// @brief A cached value, or one which is loading.
+    struct _Entry {
+        _Entry(
+            const event::SharedFuture<V>& value,
+            typename _LruList::iterator lru,
+            const std::uint64_t id
+        ):
+            value(value),
+            lru(lru),
+            id(id),
+            loaded(false)
+        {}
+
+        event::SharedFuture<V> value;       ///< The value shared with every caller.
+        typename _LruList::iterator lru;    ///< The entry's position in the LRU order.
+        clock::time_point expires;          ///< When the loaded value expires.
+        std::uint64_t id;                   ///< Distinguishes this entry from others with its key.
+        bool loaded;                        ///< Flag indicating the value has been loaded.
+    };
+
+    /// @brief A loaded entry awaiting expiry, in the order they were loaded.
+    struct _Expiry {
+        clock::time_point when; ///< When the entry expires.
+        K key;                  ///< The entry's key.
+        std::uint64_t id;       ///< The entry's id, to skip entries replaced since.
+    };
+
+    typedef std::unordered_map<K, _Entry, Hash, Equal> _EntryMap;
+
+    /// @brief Everything the cache's continuations and timer need to reach.
+    struct _State : public std::enable_shared_from_this<_State> {
+        _State(event::Loop& loop, const std::size_t capacity, const duration& ttl):
+            loop(loop),
+            capacity(capacity),
+            ttl(ttl),
+            next_id(0),
+            armed(false)
+        {}
+
+        event::Loop& loop;                  ///< The loop running the expiry timer.
+        std::size_t capacity;               ///< The most entries to hold.
+        duration ttl;                       ///< How long loaded values are kept.
+        std::uint64_t next_id;              ///< The id for the next entry.
+        _EntryMap entries;                  ///< The entries, by key.
+        _LruList lru;                       ///< Keys from most to least recently used.
+        std::deque<_Expiry> expiries;       ///< Loaded entries in order of expiry.
+        event::CancellationSource timer;    ///< Stops the expiry timer.
+        bool armed;                         ///< Flag indicating the timer is running.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Makes a future for a copy of the shared value.
+    static event::Future<V> _copy(const event::SharedFuture<V>& value){
+        return value.then([](const V& value){ return value; });
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Removes an entry from the map and the LRU order.
+    static void _erase(_State& state, typename _EntryMap::iterator entry){
+        state.lru.erase(entry->second.lru);
+        state.entries.erase(entry);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Marks the entry loaded and schedules its expiry.
+    static void _loaded(_State& state, const K& key, const std::uint64_t id){
+        auto found = state.entries.find(key);
+        if (found == state.entries.end() || found->second.id != id) {
+            return;
+        }
+
+        // Every entry lives for the same time, so expiries are always added in order.
+        _Entry& entry = found->second;
+        entry.loaded = true;
+        entry.expires = clock::now() + state.ttl;
+        state.expiries.push_back(_Expiry{entry.expires, key, id});
+        _arm(state);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Removes an entry whose load failed.
+    static void _failed(_State& state, const K& key, const std::uint64_t id){
+        auto found = state.entries.find(key);
+        if (found != state.entries.end() && found->second.id == id) {
+            _erase(state, found);
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Starts the timer for the next expiry, if it is not already running.
+    static void _arm(_State& state){
+        if (state.armed || state.expiries.empty()) {
+            return;
+        }
+
+        auto delay = std::chrono::duration_cast<duration>(
+            state.expiries.front().when - clock::now()
+        ) + duration(1);
+        state.armed = true;
+        std::weak_ptr<_State> weak_state = state.shared_from_this();
+
+        // The timer must not keep the loop running just to throw entries away.
+        event::Timeout timeout(state.loop);
+        timeout.unref();
+        timeout.start(
+            delay < duration(0) ? duration(0) : delay,
+            state.timer.token()
+        ).then([weak_state](){
+            if (auto state = weak_state.lock()) {
+                state->armed = false;
+                _expire(*state);
+                _arm(*state);
+            }
+        }, [](const error::Error&){});
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Stops the expiry timer.
+    static void _disarm(_State& state){
+        if (state.armed) {
+            state.armed = false;
+            state.timer.cancel();
+            state.timer = event::CancellationSource();
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Removes every entry which has expired.
+    static void _expire(_State& state){
+        const auto now = clock::now();
+        while (!state.expiries.empty() && state.expiries.front().when <= now) {
+            const _Expiry& expiry = state.expiries.front();
+            auto found = state.entries.find(expiry.key);
+            if (found != state.entries.end() && found->second.id == expiry.id) {
+                _erase(state, found);
+            }
+            state.expiries.pop_front();
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    std::shared_ptr<_State> m_state;    ///< The cache's state.
+};
+
+}
+}
@@ -1,3 +1,4 @@
 #pragma once
 
+#include "lw/error/Error.hpp"
 #include "lw/error/Exception.hpp"
@@ -0,0 +1,61 @@
+
+#include <uv.h>
+
+#include "lw/error/Error.hpp"
+
+namespace lw {
+namespace error {
+
+namespace {
+    class ExceptionCategory : public Category {
+    public:
+        const char* name(void) const noexcept override {
+            return "exception";
+        }
+
+        // Errors in this category always hold their exception, so the message comes from there.
+        std::string message(const std::int64_t) const override {
+            return std::string();
+        }
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+std::string uv_message(const std::int64_t code){
+    return (std::string)uv_err_name((int)code) + ": " + uv_strerror((int)code);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+const Category& exception_category(void){
+    static const ExceptionCategory category;
+    return category;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Error Error::current(void){
+    std::exception_ptr ptr = std::current_exception();
+    try {
+        std::rethrow_exception(ptr);
+    }
+    catch (const Exception& err) {
+        return Error(
+            err.error_code(),
+            std::make_shared<const _details::CaughtExceptionHolder>(ptr, err)
+        );
+    }
+    catch (const std::exception& err) {
+        return Error(-1, std::make_shared<const _details::ForeignExceptionHolder>(ptr, err.what()));
+    }
+    catch (...) {
+        return Error(
+            -1,
+            std::make_shared<const _details::ForeignExceptionHolder>(ptr, "Unknown exception.")
+        );
+    }
+}
+
+}
+}
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "lw/error/Exception.hpp"
+
+namespace lw {
+namespace error {
+
+/// @brief Stands in for a caught exception which is not an `Exception`.
+LW_DEFINE_EXCEPTION(ForeignException);
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace _details {
+    /// @internal
+    /// @brief Type-erased holder for an exception, preserving its type for rethrowing.
+    class ExceptionHolder {
+    public:
+        virtual ~ExceptionHolder(void){}
+
+        /// @brief Gives access to the held exception.
+        virtual const Exception& get(void) const = 0;
+
+        /// @brief Throws the held exception as its original type.
+        [[noreturn]] virtual void raise(void) const = 0;
+    };
+
+    /// @internal
+    /// @brief Holds an exception of a specific type.
+    template<typename E>
+    class TypedExceptionHolder : public ExceptionHolder {
+    public:
+        explicit TypedExceptionHolder(const E& err):
+            m_error(err)
+        {}
+
+        const Exception& get(void) const override {
+            return m_error;
+        }
+
+        [[noreturn]] void raise(void) const override {
+            throw m_error;
+        }
+
+    private:
+        E m_error;
+    };
+
+    /// @internal
+    /// @brief Holds a caught exception, rethrowing the very same exception object.
+    ///
+    /// Unlike `TypedExceptionHolder` this does not need the exception's static type, so it keeps
+    /// the most derived type of an exception caught through a base class reference. The exception
+    /// object is owned by the `std::exception_ptr`, which the major standard libraries rethrow
+    /// without copying, so `get` refers to that same object.
+    class CaughtExceptionHolder : public ExceptionHolder {
+    public:
+        CaughtExceptionHolder(std::exception_ptr ptr, const Exception& err):
+            m_ptr(std::move(ptr)),
+            m_error(&err)
+        {}
+
+        const Exception& get(void) const override {
+            return *m_error;
+        }
+
+        [[noreturn]] void raise(void) const override {
+            std::rethrow_exception(m_ptr);
+        }
+
+    private:
+        std::exception_ptr m_ptr;   ///< The caught exception.
+        const Exception* m_error;   ///< The exception object held by `m_ptr`.
+    };
+
+    /// @internal
+    /// @brief Holds a caught exception which is not an `Exception`.
+    ///
+    /// Handlers see a `ForeignException` carrying the original's message, while `raise` still
+    /// rethrows the original exception.
+    class ForeignExceptionHolder : public ExceptionHolder {
+    public:
+        ForeignExceptionHolder(std::exception_ptr ptr, const std::string& message):
+            m_ptr(std::move(ptr)),
+            m_error(-1, message)
+        {}
+
+        const Exception& get(void) const override {
+            return m_error;
+        }
+
+        [[noreturn]] void raise(void) const override {
+            std::rethrow_exception(m_ptr);
+        }
+
+    private:
+        std::exception_ptr m_ptr;   ///< The caught exception.
+        ForeignException m_error;   ///< The stand-in given to handlers.
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Describes a family of error codes.
+///
+/// Categories turn codes into messages only when someone asks, so an error can be created and
+/// passed around without formatting or allocating anything. Categories are singletons and are
+/// compared by address.
+class Category {
+public:
+    virtual ~Category(void){}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief A short name for the category.
+    virtual const char* name(void) const noexcept = 0;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Formats the message for the given error code.
+    virtual std::string message(const std::int64_t code) const = 0;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Creates the exception to throw for the given error code.
+    ///
+    /// By default this is a plain `Exception` carrying the formatted message.
+    virtual std::shared_ptr<const _details::ExceptionHolder> make_exception(
+        const std::int64_t code
+    ) const {
+        return std::make_shared<const _details::TypedExceptionHolder<Exception>>(
+            Exception(code, message(code))
+        );
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Formats a libuv error code as `"<name>: <description>"`.
+///
+/// @param code A libuv error code.
+///
+/// @return The formatted message, identical to the one made by `LW_UV_ERROR`.
+std::string uv_message(const std::int64_t code);
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Category for libuv error codes.
+///
+/// @tparam E The exception type to use when the error must be thrown.
+template<typename E>
+class UvCategory : public Category {
+public:
+    const char* name(void) const noexcept override {
+        return "uv";
+    }
+
+    std::string message(const std::int64_t code) const override {
+        return uv_message(code);
+    }
+
+    std::shared_ptr<const _details::ExceptionHolder> make_exception(
+        const std::int64_t code
+    ) const override {
+        return std::make_shared<const _details::TypedExceptionHolder<E>>(E(code, message(code)));
+    }
+};
+
+/// @brief Retrieves the libuv category which throws errors as `E`.
+///
+/// @tparam E The exception type to use when the error must be thrown.
+template<typename E = Exception>
+const Category& uv_category(void){
+    static const UvCategory<E> category;
+    return category;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Category for errors made from exceptions.
+const Category& exception_category(void);
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief A compact error value made of a code and its category.
+///
+/// Errors are cheap to create and copy: making one from a code and category does not allocate, and
+/// the message is only formatted when asked for. Errors made from an `Exception` keep the original
+/// exception, including its type, for handlers which want it.
+///
+/// @par Example
+/// @code{.cpp}
+///     promise.reject(lw::error::Error(UV_ECONNRESET, lw::error::uv_category<StreamError>()));
+///
+///     future.then([](){
+///         // ...
+///     }, [](const lw::error::Error& err){
+///         if (err.code() == UV_ECONNRESET) {
+///             // No message formatted, nothing allocated.
+///         }
+///     });
+/// @endcode
+class Error {
+public:
+    /// @brief Constructs an error from a code and the category it belongs to.
+    ///
+    /// @param code     The error code.
+    /// @param category The category giving meaning to `code`.
+    Error(const std::int64_t code, const Category& category) noexcept:
+        m_code(code),
+        m_category(&category),
+        m_made(nullptr)
+    {}
+
+    /// @brief Copies the error.
+    ///
+    /// An exception the category made for `other` is not shared, the copy makes its own if needed.
+    Error(const Error& other) noexcept:
+        m_code(other.m_code),
+        m_category(other.m_category),
+        m_exception(other.m_exception),
+        m_made(nullptr)
+    {}
+
+    Error(Error&& other) noexcept:
+        m_code(other.m_code),
+        m_category(other.m_category),
+        m_exception(std::move(other.m_exception)),
+        m_made(other.m_made.exchange(nullptr))
+    {}
+
+    ~Error(void){
+        delete m_made.load();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    Error& operator=(const Error& other) noexcept {
+        if (this != &other) {
+            delete m_made.exchange(nullptr);
+            m_code = other.m_code;
+            m_category = other.m_category;
+            m_exception = other.m_exception;
+        }
+        return *this;
+    }
+
+    Error& operator=(Error&& other) noexcept {
+        if (this != &other) {
+            delete m_made.exchange(other.m_made.exchange(nullptr));
+            m_code = other.m_code;
+            m_category = other.m_category;
+            m_exception = std::move(other.m_exception);
+        }
+        return *this;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Wraps an exception as an error value.
+    ///
+    /// This is implicit so any `Exception` can be given where an `Error` is expected.
+    ///
+    /// @tparam E A type derived from `Exception`.
+    ///
+    /// @param err The exception to wrap.
+    template<
+        typename E,
+        typename std::enable_if<std::is_base_of<Exception, E>::value>::type* = nullptr
+    >
+    Error(const E& err):
+        m_code(err.error_code()),
+        m_category(&exception_category()),
+        m_exception(std::make_shared<const _details::TypedExceptionHolder<E>>(err)),
+        m_made(nullptr)
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Makes an error from the exception currently being handled, keeping its type.
+    ///
+    /// This must be called from within a `catch` block. Use it rather than wrapping the caught
+    /// reference, which only knows the type it was caught as: an error made with `Error(err)` from
+    /// `catch (const Exception& err)` would rethrow a plain `Exception`.
+    ///
+    /// Exceptions which are not `Exception`s are presented to handlers as a `ForeignException`
+    /// with code -1 and the original's `what()`, or "Unknown exception." for non-`std::exception`
+    /// types.
+    ///
+    /// @return An error which rethrows the caught exception from `raise`.
+    static Error current(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The error code.
+    std::int64_t code(void) const {
+        return m_code;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The category of the error code.
+    const Category& category(void) const {
+        return *m_category;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Formats the error's message.
+    std::string message(void) const {
+        return m_exception ? std::string(m_exception->get().what()) : m_category->message(m_code);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Gives the error as an exception.
+    ///
+    /// If the error was not made from an exception then one is created by the category the first
+    /// time this is called. That may happen on several threads sharing the error at once.
+    const Exception& exception(void) const {
+        return _holder().get();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Throws the error as its exception type.
+    void raise(void) const {
+        _holder().raise();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    Error(const std::int64_t code, std::shared_ptr<const _details::ExceptionHolder> exception):
+        m_code(code),
+        m_category(&exception_category()),
+        m_exception(std::move(exception)),
+        m_made(nullptr)
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    typedef std::shared_ptr<const _details::ExceptionHolder> _Holder;
+
+    /// @brief The held exception, or the one made by the category.
+    ///
+    /// Errors are shared by reference across threads, so a made exception is published with a
+    /// compare and swap. A thread which loses the race throws its own away.
+    const _details::ExceptionHolder& _holder(void) const {
+        if (m_exception) {
+            return *m_exception;
+        }
+
+        _Holder* made = m_made.load(std::memory_order_acquire);
+        if (!made) {
+            _Holder* fresh = new _Holder(m_category->make_exception(m_code));
+            if (m_made.compare_exchange_strong(
+                made,
+                fresh,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire
+            )) {
+                made = fresh;
+            }
+            else {
+                delete fresh;
+            }
+        }
+        return **made;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    std::int64_t m_code;                        ///< The error code.
+    const Category* m_category;                 ///< The code's category.
+    _Holder m_exception;                        ///< The exception the error was made from.
+    mutable std::atomic<_Holder*> m_made;       ///< The exception made by the category.
+};
+
+}
+}
@@ -1,13 +1,27 @@
 #pragma once
 
 #include "lw/event/BasicStream.hpp"
+#include "lw/event/Cancellation.hpp"
+#include "lw/event/CooperativeScheduler.hpp"
+#include "lw/event/Coroutine.hpp"
 #include "lw/event/Emitter.hpp"
+#include "lw/event/Executor.hpp"
+#include "lw/event/HandlePool.hpp"
 #include "lw/event/Idle.hpp"
+#include "lw/event/iterate.hpp"
+#include "lw/event/join.hpp"
 #include "lw/event/Loop.hpp"
+#include "lw/event/PreciseTimeout.hpp"
 #include "lw/event/Promise.hpp"
 #include "lw/event/Promise.void.hpp"
+#include "lw/event/SharedFuture.hpp"
+#include "lw/event/Stats.hpp"
 #include "lw/event/Timeout.hpp"
+#include "lw/event/TimerWheel.hpp"
+#include "lw/event/UniqueFunction.hpp"
 #include "lw/event/util.hpp"
 
+#include "lw/event/Cancellation.impl.hpp"
+#include "lw/event/Loop.impl.hpp"
 #include "lw/event/Promise.impl.hpp"
 #include "lw/event/Timeout.impl.hpp"
@@ -1,22 +1,39 @@
 
-#include <cstdlib>
+#include <memory>
 #include <uv.h>
 
 #include "lw/event/BasicStream.hpp"
+#include "lw/event/HandlePool.hpp"
 #include "lw/event/Promise.impl.hpp"
 
 namespace lw {
 namespace event {
 
 namespace _details {
+    /// @internal
+    /// @brief An in-flight write, it owns everything the write needs until libuv calls back.
     struct WriteRequest {
-        WriteRequest( void ){
+        static void* operator new(std::size_t){
+            return HandlePool::allocate<WriteRequest>();
+        }
+
+        static void operator delete(void* ptr){
+            HandlePool::deallocate(static_cast<WriteRequest*>(ptr));
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        WriteRequest(BasicStream::buffer_ptr_t&& buffer, std::shared_ptr<void>&& state):
+            buffer(std::move(buffer)),
+            state(std::move(state))
+        {
             request.data = (void*)this;
         }
 
-        uv_write_t request;
-        Promise< std::size_t > promise;
-        std::size_t size;
+        uv_write_t request;                 ///< The libuv write request.
+        Promise<std::size_t> promise;       ///< Resolved with the bytes written.
+        BasicStream::buffer_ptr_t buffer;   ///< Keeps the data alive until it is written.
+        std::shared_ptr<void> state;        ///< Keeps the stream open until the write finishes.
     };
 }
 
@@ -34,7 +51,7 @@ BasicStream::BasicStream( uv_stream_s* handle ):
 
 BasicStream::_State::~_State(void){
     if (handle) {
-        uv_close((uv_handle_t*)handle, [](uv_handle_t* handle){ std::free(handle); });
+        HandlePool::close((uv_handle_t*)handle);
     }
 }
 
@@ -61,22 +78,25 @@ void BasicStream::stop_read( void ){
 // ---------------------------------------------------------------------------------------------- //
 
 Future< std::size_t > BasicStream::write( buffer_ptr_t buffer ){
-    auto write_req = std::make_shared< _details::WriteRequest >();
-    write_req->size = buffer->size();
     uv_buf_t buffers[ 1 ];
     *buffers = uv_buf_init( (char*)buffer->data(), buffer->size() );
+    std::unique_ptr< _details::WriteRequest > write_req(
+        new _details::WriteRequest( std::move( buffer ), m_state )
+    );
     int res = uv_write(
         &write_req->request,
         m_state->handle,
         buffers, 1,
         []( uv_write_t* req, int status ){
-            auto* write_req = (_details::WriteRequest*)req->data;
-            auto& promise   = write_req->promise;
+            std::unique_ptr< _details::WriteRequest > write_req(
+                (_details::WriteRequest*)req->data
+            );
+            auto& promise = write_req->promise;
             if( status < 0 ){
-                promise.reject( LW_UV_ERROR( StreamError, status ) );
+                promise.reject( error::Error( status, error::uv_category< StreamError >() ) );
             }
             else {
-                promise.resolve( write_req->size );
+                promise.resolve( write_req->buffer->size() );
             }
         }
     );
@@ -85,12 +105,8 @@ Future< std::size_t > BasicStream::write( buffer_ptr_t buffer ){
         throw LW_UV_ERROR( StreamError, res );
     }
 
-    auto state = m_state;
-    return write_req->promise.future()
-        .then([ write_req, state, buffer ]( const std::size_t bytes_written ){
-            return bytes_written;
-        })
-    ;
+    // libuv owns the request until the write callback.
+    return write_req.release()->promise.future();
 }
 
 // ---------------------------------------------------------------------------------------------- //
@@ -142,6 +158,7 @@ Future<std::size_t> BasicStream::_read(void){
 // ---------------------------------------------------------------------------------------------- //
 
 void BasicStream::_stop_read( void ){
+    m_state->read_cancellation.reset();
     m_state->read_promise.resolve( m_state->read_count );
     m_state->read_promise.reset();
     m_state->read_count = 0;
@@ -149,6 +166,30 @@ void BasicStream::_stop_read( void ){
 
 // ---------------------------------------------------------------------------------------------- //
 
+void BasicStream::_bind_cancellation(const CancellationToken& token){
+    std::weak_ptr<_State> weak_state = m_state;
+    m_state->read_cancellation = token.on_cancel([weak_state](){
+        if (auto state = weak_state.lock()) {
+            BasicStream(state)._cancel_read();
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void BasicStream::_cancel_read(void){
+    if (!m_state->read_callback) {
+        return;
+    }
+    uv_read_stop(m_state->handle);
+    m_state->read_callback = nullptr;
+    m_state->read_count = 0;
+    m_state->read_promise.reject(CancelledError(1, "Stream read cancelled."));
+    m_state->read_promise.reset();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
 memory::Buffer& BasicStream::_next_read_buffer( void ){
     if( m_state->idle_read_buffers.size() == 0 ){
         m_state->idle_read_buffers.emplace_back( memory::Buffer( 1024 ) );
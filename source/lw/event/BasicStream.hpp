@@ -1,11 +1,13 @@
 #pragma once
 
-#include <functional>
 #include <list>
+#include <memory>
 #include <type_traits>
 
 #include "lw/error.hpp"
+#include "lw/event/Cancellation.hpp"
 #include "lw/event/Promise.hpp"
+#include "lw/event/UniqueFunction.hpp"
 #include "lw/memory.hpp"
 
 struct uv_stream_s;
@@ -24,7 +26,7 @@ public:
     /// @brief Read callback functor type.
     ///
     /// @param buffer The buffer containing the read data.
-    typedef std::function<void(buffer_ptr_t buffer)> read_callback_t;
+    typedef UniqueFunction<void(buffer_ptr_t buffer)> read_callback_t;
 
     // ------------------------------------------------------------------------------------------ //
 
@@ -52,10 +54,32 @@ public:
             "`Func` must be compatible with `BasicStream::read_callback_t`."
         );
         auto state = m_state;
-        m_state->read_callback = [state, func](const buffer_ptr_t& buffer){ func(buffer); };
+        m_state->read_callback = [state, func = std::forward<Func>(func)](
+            buffer_ptr_t buffer
+        ) mutable {
+            func(buffer);
+        };
         return _read();
     }
 
+    /// @brief Starts the stream reading until it ends or the token is cancelled.
+    ///
+    /// Cancelling the token stops the read and rejects the returned promise with a
+    /// `CancelledError`.
+    ///
+    /// @tparam Func A functor matching the `read_callback_t`.
+    ///
+    /// @param func  The functor to call when there is data available.
+    /// @param token The token to stop reading with.
+    ///
+    /// @return A promise for the total number of bytes read.
+    template<typename Func>
+    Future<std::size_t> read(Func&& func, const CancellationToken& token){
+        auto future = read(std::forward<Func>(func));
+        _bind_cancellation(token);
+        return future;
+    }
+
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief Stops the active read, and resolves the associated promise.
@@ -80,6 +104,7 @@ protected:
         uv_stream_s*    handle;         ///< The underlying stream handle.
         std::size_t     read_count;     ///< The running tally of bytes read.
         read_callback_t read_callback;  ///< The functor to call with read data.
+        CancellationRegistration read_cancellation; ///< Stops the read when cancelled.
 
         Promise<std::size_t> read_promise;              ///< The read promise.
         std::list<memory::Buffer> idle_read_buffers;    ///< List of available read buffers.
@@ -142,6 +167,18 @@ private:
 
     // ------------------------------------------------------------------------------------------ //
 
+    /// @brief Stops the active read when the token is cancelled.
+    ///
+    /// @param token The token to watch.
+    void _bind_cancellation(const CancellationToken& token);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Stops the active read and rejects the read promise with a `CancelledError`.
+    void _cancel_read(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
     /// @brief Gets an available read buffer.
     ///
     /// If no buffers are available, then a new one is allocated.
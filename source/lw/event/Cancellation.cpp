@@ -0,0 +1,76 @@
+
+#include <exception>
+
+#include "lw/event/Cancellation.hpp"
+
+namespace lw {
+namespace event {
+
+void CancellationRegistration::reset(void){
+    auto state = m_state.lock();
+    m_state.reset();
+
+    // While cancelling, callbacks which have been called, or are being called, are emptied and must
+    // stay where they are. Those still waiting are removed so they are never called, as an earlier
+    // callback may have destroyed whatever they refer to. Once cancelled there is nothing left.
+    if (!state || (state->cancelled && !state->cancelling)) {
+        return;
+    }
+    if (!state->cancelled || *m_callback) {
+        state->callbacks.erase(m_callback);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+CancellationRegistration CancellationToken::on_cancel(UniqueFunction<void(void)> func) const {
+    if (!m_state) {
+        return CancellationRegistration();
+    }
+    if (m_state->cancelled) {
+        func();
+        return CancellationRegistration();
+    }
+    return CancellationRegistration(
+        m_state,
+        m_state->callbacks.insert(m_state->callbacks.end(), std::move(func))
+    );
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void CancellationSource::cancel(void){
+    if (m_state->cancelled) {
+        return;
+    }
+    m_state->cancelled = true;
+
+    // Keep the state alive in case a callback releases the last token. A throwing callback must
+    // not strand the rest, so the first error is held until every callback has run.
+    //
+    // Each callback is emptied rather than removed before it is called. This keeps the iterator
+    // valid while callbacks reset the registrations of those after it.
+    auto state = m_state;
+    std::exception_ptr error;
+    state->cancelling = true;
+    for (auto itr = state->callbacks.begin(); itr != state->callbacks.end(); ++itr) {
+        auto callback = std::move(*itr);
+        *itr = nullptr;
+        try {
+            callback();
+        }
+        catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    state->cancelling = false;
+    state->callbacks.clear();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <utility>
+
+#include "lw/error.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+#include "lw/event/UniqueFunction.hpp"
+
+namespace lw {
+namespace event {
+
+LW_DEFINE_EXCEPTION(CancelledError);
+
+class CancellationToken;
+
+namespace _details {
+    /// @internal
+    /// @brief The state shared between a `CancellationSource` and its tokens.
+    struct CancellationState {
+        typedef std::list<UniqueFunction<void(void)>> callback_list;
+
+        CancellationState(void):
+            cancelled(false),
+            cancelling(false)
+        {}
+
+        bool cancelled;             ///< Flag indicating cancellation has been requested.
+        bool cancelling;            ///< Flag indicating the callbacks are being called.
+        callback_list callbacks;    ///< Functors to call upon cancellation.
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Keeps a cancellation callback registered with a `CancellationToken`.
+///
+/// The callback is removed when the registration is destroyed or reset, so operations hold one for
+/// exactly as long as they are in flight.
+class CancellationRegistration {
+public:
+    CancellationRegistration(void){}
+
+    CancellationRegistration(CancellationRegistration&& other):
+        m_state(std::move(other.m_state)),
+        m_callback(other.m_callback)
+    {}
+
+    CancellationRegistration(const CancellationRegistration&) = delete;
+
+    ~CancellationRegistration(void){
+        reset();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    CancellationRegistration& operator=(CancellationRegistration&& other){
+        reset();
+        m_state = std::move(other.m_state);
+        m_callback = other.m_callback;
+        return *this;
+    }
+
+    CancellationRegistration& operator=(const CancellationRegistration&) = delete;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Removes the callback from the token if it has not already been called.
+    void reset(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    friend class CancellationToken;
+
+    typedef _details::CancellationState::callback_list::iterator callback_iterator;
+
+    CancellationRegistration(
+        const std::shared_ptr<_details::CancellationState>& state,
+        callback_iterator callback
+    ):
+        m_state(state),
+        m_callback(callback)
+    {}
+
+    std::weak_ptr<_details::CancellationState> m_state; ///< The state the callback is in.
+    callback_iterator m_callback;                       ///< The position of the callback.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief A handle for observing cancellation requested through a `CancellationSource`.
+///
+/// Tokens are cheap to copy and may be passed to any number of operations. A default constructed
+/// token can never be cancelled. Tokens, like the event loop, are not thread safe and must only be
+/// used from the thread running the loop.
+class CancellationToken {
+public:
+    /// @brief Constructs a token which will never be cancelled.
+    CancellationToken(void){}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if cancellation has been requested.
+    bool is_cancelled(void) const {
+        return m_state && m_state->cancelled;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if this token could ever be cancelled.
+    bool can_be_cancelled(void) const {
+        return (bool)m_state;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Registers a functor to call when cancellation is requested.
+    ///
+    /// If cancellation has already been requested then the functor is called immediately.
+    ///
+    /// @param func The functor to call upon cancellation.
+    ///
+    /// @return A registration which removes the functor when it is destroyed.
+    CancellationRegistration on_cancel(UniqueFunction<void(void)> func) const;
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    friend class CancellationSource;
+
+    explicit CancellationToken(const std::shared_ptr<_details::CancellationState>& state):
+        m_state(state)
+    {}
+
+    std::shared_ptr<_details::CancellationState> m_state; ///< The shared cancellation state.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Requests cancellation of every operation given one of its tokens.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::event::CancellationSource source;
+///     file.read(4096, source.token())
+///         .then([](lw::memory::Buffer&& data){
+///             // ...
+///         }, [](const lw::error::Exception& err){
+///             // `err` is a `lw::event::CancelledError` if `source.cancel()` was called first.
+///         });
+///
+///     lw::event::wait(loop, std::chrono::seconds(5)).then([&](){ source.cancel(); });
+/// @endcode
+class CancellationSource {
+public:
+    CancellationSource(void):
+        m_state(std::make_shared<_details::CancellationState>())
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Creates a token tied to this source.
+    CancellationToken token(void) const {
+        return CancellationToken(m_state);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if cancellation has been requested.
+    bool is_cancelled(void) const {
+        return m_state->cancelled;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Requests cancellation, calling every registered functor in registration order.
+    ///
+    /// Calling `cancel` more than once has no further effect.
+    ///
+    /// @throws ... The first exception thrown by a callback, rethrown once every callback has run.
+    void cancel(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    std::shared_ptr<_details::CancellationState> m_state; ///< The shared cancellation state.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Makes a future which is rejected with a `CancelledError` if the token is cancelled
+/// before the given future is finished.
+///
+/// This allows any part of a promise chain to be abandoned. Rejections propagate down the chain
+/// as normal, so every later step will see the `CancelledError`. The operation behind `future` is
+/// not stopped, use the operations' own token parameters for that.
+///
+/// @param future The future to wrap.
+/// @param token  The token to observe.
+///
+/// @return A future which is finished with either `future` or the cancellation.
+template<typename T>
+Future<T> cancellable(Future<T> future, const CancellationToken& token);
+
+}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "lw/event/Cancellation.hpp"
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace _details {
+    /// @internal
+    /// @brief The state shared by the two ways a `cancellable` future can be finished.
+    template<typename T>
+    struct CancellableState {
+        Promise<T> promise;
+        CancellationRegistration registration;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Continuation forwarding the wrapped future's outcome unless already cancelled.
+    template<typename T>
+    struct CancellableContinuation {
+        typedef typename StoredValue<T>::type value_type;
+
+        explicit CancellableContinuation(const std::shared_ptr<CancellableState<T>>& state):
+            state(state)
+        {}
+
+        void operator()(value_type* value, const error::Error* err){
+            state->registration.reset();
+            if (state->promise.is_finished()) {
+                return;
+            }
+            if (value) {
+                resolve_promise(state->promise, std::move(*value));
+            }
+            else {
+                state->promise.reject(*err);
+            }
+        }
+
+        std::shared_ptr<CancellableState<T>> state;
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename T>
+Future<T> cancellable(Future<T> future, const CancellationToken& token){
+    typedef _details::CancellableState<T> State;
+
+    auto state = std::make_shared<State>();
+    auto result = state->promise.future();
+    std::weak_ptr<State> weak_state = state;
+    state->registration = token.on_cancel([weak_state](){
+        auto state = weak_state.lock();
+        if (state && !state->promise.is_finished()) {
+            state->promise.reject(CancelledError(1, "Operation cancelled."));
+        }
+    });
+    _details::FutureAccess::state(future).template then<_details::CancellableContinuation<T>>(
+        state
+    );
+    return result;
+}
+
+}
+}
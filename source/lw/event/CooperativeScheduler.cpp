@@ -0,0 +1,108 @@
+
+#include <uv.h>
+
+#include "lw/event/Cancellation.hpp"
+#include "lw/event/CooperativeScheduler.hpp"
+#include "lw/event/HandlePool.hpp"
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace {
+    /// @brief Rejects the promise, ignoring the error if its future has been dropped.
+    ///
+    /// Tasks are usually scheduled without keeping the future. `Promise::reject` raises an error
+    /// nobody can handle, and here it would escape a destructor or a libuv callback.
+    void reject_quietly(Promise<>& promise, const error::Error& err) noexcept {
+        try {
+            promise.reject(err);
+        }
+        catch (...) {
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+CooperativeScheduler::CooperativeScheduler(Loop& loop, const duration budget):
+    m_loop(loop),
+    m_budget(budget),
+    m_check(HandlePool::allocate<uv_check_s>()),
+    m_idle(HandlePool::allocate<uv_idle_s>())
+{
+    uv_check_init(loop.lowest_layer(), m_check);
+    uv_idle_init(loop.lowest_layer(), m_idle);
+    m_check->data = (void*)this;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+CooperativeScheduler::~CooperativeScheduler(void){
+    HandlePool::close((uv_handle_t*)m_check);
+    HandlePool::close((uv_handle_t*)m_idle);
+
+    for (auto& lane : m_tasks) {
+        std::deque<_Entry> tasks;
+        tasks.swap(lane);
+        for (_Entry& entry : tasks) {
+            reject_quietly(entry.promise, CancelledError(1, "Scheduler destroyed."));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Future<> CooperativeScheduler::schedule(Task task, const Priority priority){
+    if (size() == 0) {
+        uv_check_start(m_check, [](uv_check_t* handle){
+            ((CooperativeScheduler*)handle->data)->_run_slice();
+        });
+        uv_idle_start(m_idle, [](uv_idle_t*){});
+    }
+
+    auto& lane = m_tasks[(std::size_t)priority];
+    lane.push_back(_Entry{std::move(task), Promise<>(m_loop)});
+    return lane.back().promise.future();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void CooperativeScheduler::_run_slice(void){
+    const auto deadline = clock::now() + m_budget;
+    for (auto& lane : m_tasks) {
+        // Each lane gets at least one step, however much of the budget is gone.
+        if (!lane.empty()) {
+            _step(lane);
+        }
+        while (!lane.empty() && clock::now() < deadline) {
+            _step(lane);
+        }
+    }
+
+    if (size() == 0) {
+        uv_check_stop(m_check);
+        uv_idle_stop(m_idle);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void CooperativeScheduler::_step(std::deque<_Entry>& lane){
+    _Entry entry = std::move(lane.front());
+    lane.pop_front();
+
+    try {
+        if (entry.task() == Progress::MORE) {
+            lane.push_back(std::move(entry));
+            return;
+        }
+        entry.promise.resolve();
+    }
+    catch (const error::Exception&) {
+        reject_quietly(entry.promise, error::Error::current());
+    }
+}
+
+}
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+
+#include "lw/event/Loop.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+#include "lw/event/UniqueFunction.hpp"
+
+struct uv_check_s;
+struct uv_idle_s;
+
+namespace lw {
+namespace event {
+
+/// @brief Time-slices resumable CPU tasks onto a loop between its I/O.
+///
+/// Each task is a functor which does a little work each time it is called and reports whether it
+/// has more to do. Once per iteration, after the loop has polled for I/O, the scheduler takes turns
+/// stepping through its tasks until the iteration's time budget is spent. Long background jobs such
+/// as compaction or cache warming then share the loop with I/O instead of stalling it.
+///
+/// Tasks are queued in `Priority` lanes. The higher lanes are stepped first, and once the budget is
+/// spent each lower lane with tasks waiting still gets a single step so none of them starve. A step
+/// should therefore stay well under the budget. The scheduler must only be used from its loop's
+/// thread, use `Loop::post` to schedule from elsewhere.
+///
+/// @par Example
+/// @code{.cpp}
+///     event::CooperativeScheduler scheduler(loop, std::chrono::milliseconds(2));
+///     auto it = entries.begin();
+///     scheduler.schedule([&](){
+///         for (int i = 0; i < 100 && it != entries.end(); ++i, ++it) {
+///             compact(*it);
+///         }
+///         return it == entries.end()
+///             ? event::CooperativeScheduler::Progress::DONE
+///             : event::CooperativeScheduler::Progress::MORE;
+///     }).then([](){
+///         std::cout << "Compaction finished." << std::endl;
+///     });
+/// @endcode
+class CooperativeScheduler {
+public:
+    /// @brief What a task reports after each step.
+    enum class Progress {
+        MORE,   ///< The task has more work and should be called again.
+        DONE    ///< The task is finished.
+    };
+
+    /// @brief The resumable task type.
+    typedef UniqueFunction<Progress(void)> Task;
+
+    typedef std::chrono::nanoseconds duration; ///< The type used for time budgets.
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Sets up the scheduler on the loop.
+    ///
+    /// @param loop   The loop to run the tasks on.
+    /// @param budget The most time to spend on tasks in each iteration of the loop.
+    explicit CooperativeScheduler(
+        Loop& loop,
+        const duration budget = std::chrono::milliseconds(2)
+    );
+
+    CooperativeScheduler(const CooperativeScheduler&) = delete;
+    CooperativeScheduler& operator=(const CooperativeScheduler&) = delete;
+
+    /// @brief Drops any unfinished tasks, rejecting their futures with a `CancelledError`.
+    ~CooperativeScheduler(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Queues a task to be stepped until it is done.
+    ///
+    /// The loop is kept running while any tasks are queued.
+    ///
+    /// @param task     The task to run.
+    /// @param priority The lane to queue the task in.
+    ///
+    /// @return A future resolved once the task reports it is done, or rejected with the
+    ///         `error::Exception` it throws.
+    Future<> schedule(Task task, const Priority priority = Priority::NORMAL);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of unfinished tasks.
+    std::size_t size(void) const {
+        std::size_t size = 0;
+        for (const auto& lane : m_tasks) {
+            size += lane.size();
+        }
+        return size;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The most time spent on tasks in each iteration.
+    duration budget(void) const {
+        return m_budget;
+    }
+
+    /// @brief Changes the time spent on tasks in each iteration.
+    ///
+    /// @param budget The new budget, which takes effect from the next iteration.
+    void budget(const duration budget){
+        m_budget = budget;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    /// @brief A queued task and the promise for its completion.
+    struct _Entry {
+        Task task;
+        Promise<> promise;
+    };
+
+    typedef std::chrono::steady_clock clock;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Steps through the tasks until the budget is spent or they are all done.
+    void _run_slice(void);
+
+    /// @brief Takes one step of the task at the front of the lane.
+    void _step(std::deque<_Entry>& lane);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    Loop& m_loop;                               ///< The loop the tasks run on.
+    duration m_budget;                          ///< The time to spend on tasks each iteration.
+    std::deque<_Entry> m_tasks[priority_count]; ///< The unfinished tasks of each lane.
+    uv_check_s* m_check;                        ///< Runs a time slice after each poll.
+    uv_idle_s* m_idle;                          ///< Stops the poll from blocking.
+};
+
+}
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define LW_HAS_COROUTINES 1
+#endif
+
+#ifdef LW_HAS_COROUTINES
+
+#include <coroutine>
+#include <optional>
+#include <utility>
+
+#include "lw/error.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+namespace _details {
+
+/// @brief Suspends a coroutine until a `Future` is finished.
+///
+/// The awaiter lives in the coroutine frame while it is suspended, so the outcome is written
+/// straight into it by a continuation stored inline in the future's shared state.
+///
+/// @tparam T The promised type.
+template<typename T>
+class FutureAwaiter {
+public:
+    typedef typename StoredValue<T>::type value_type;
+
+    explicit FutureAwaiter(Future<T>&& future):
+        m_future(std::move(future))
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Collects the outcome without suspending if the future is already finished.
+    bool await_ready(void){
+        SharedState<T>& state = FutureAccess::state(m_future);
+        if (!state.is_ready()) {
+            return false;
+        }
+        state.template then<_Resume>(this, std::coroutine_handle<>());
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Registers the coroutine to be resumed once the future finishes.
+    void await_suspend(std::coroutine_handle<> handle){
+        FutureAccess::state(m_future).template then<_Resume>(this, handle);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Returns the resolved value.
+    ///
+    /// @throws error::Exception If the future was rejected.
+    T await_resume(void){
+        if (m_error) {
+            m_error->raise();
+        }
+        return _take(std::is_void<T>());
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    /// @brief Continuation which records the outcome and resumes the coroutine.
+    struct _Resume {
+        _Resume(FutureAwaiter* awaiter, std::coroutine_handle<> handle):
+            awaiter(awaiter),
+            handle(handle)
+        {}
+
+        void operator()(value_type* value, const error::Error* err){
+            if (value) {
+                awaiter->m_value.emplace(std::move(*value));
+            }
+            else {
+                awaiter->m_error.emplace(*err);
+            }
+            if (handle) {
+                handle.resume();
+            }
+        }
+
+        FutureAwaiter* awaiter;
+        std::coroutine_handle<> handle;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    T _take(std::false_type){
+        return std::move(*m_value);
+    }
+
+    void _take(std::true_type){}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    Future<T> m_future;
+    std::optional<value_type> m_value;
+    std::optional<error::Error> m_error;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Base for the coroutine promise of `Future`-returning coroutines.
+///
+/// Coroutines start running immediately when called and their frame is destroyed as soon as they
+/// return, exactly like a function which builds a promise chain.
+///
+/// @tparam T The promised type.
+template<typename T>
+class CoroutinePromiseBase {
+public:
+    Future<T> get_return_object(void){
+        return m_promise.future();
+    }
+
+    std::suspend_never initial_suspend(void) noexcept {
+        return {};
+    }
+
+    std::suspend_never final_suspend(void) noexcept {
+        return {};
+    }
+
+    /// @brief Rejects the future with errors escaping the coroutine body.
+    ///
+    /// Exceptions which are not `error::Exception`s reject it with an `error::ForeignException`,
+    /// so the future is always settled. Nothing escapes to whoever resumed the coroutine: if the
+    /// future was dropped, the rejection is discarded.
+    void unhandled_exception(void) noexcept {
+        try {
+            m_promise.reject(error::Error::current());
+        }
+        catch (...) {
+        }
+    }
+
+protected:
+    Promise<T> m_promise;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename T>
+class CoroutinePromise : public CoroutinePromiseBase<T> {
+public:
+    template<typename Value>
+    void return_value(Value&& value){
+        this->m_promise.resolve(std::forward<Value>(value));
+    }
+};
+
+template<>
+class CoroutinePromise<void> : public CoroutinePromiseBase<void> {
+public:
+    void return_void(void){
+        this->m_promise.resolve();
+    }
+};
+
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Suspends the current coroutine until the future is finished.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::event::Future<std::size_t> copy(lw::io::File& in, lw::io::File& out){
+///         std::size_t total = 0;
+///         while (true) {
+///             lw::memory::Buffer chunk = co_await in.read(4096);
+///             if (chunk.size() == 0) {
+///                 co_return total;
+///             }
+///             co_await out.write(chunk);
+///             total += chunk.size();
+///         }
+///     }
+/// @endcode
+///
+/// @param future The future to wait on.
+///
+/// @return The resolved value. Rejections are thrown as `error::Exception`.
+template<typename T>
+_details::FutureAwaiter<T> operator co_await(Future<T>&& future){
+    return _details::FutureAwaiter<T>(std::move(future));
+}
+
+/// @copydoc operator co_await(Future<T>&&)
+template<typename T>
+_details::FutureAwaiter<T> operator co_await(Future<T>& future){
+    return _details::FutureAwaiter<T>(Future<T>(future));
+}
+
+}
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Allows functions returning `lw::event::Future` to be coroutines.
+template<typename T, typename... Args>
+struct std::coroutine_traits<lw::event::Future<T>, Args...> {
+    typedef lw::event::_details::CoroutinePromise<T> promise_type;
+};
+
+#endif
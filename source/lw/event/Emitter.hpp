@@ -1,6 +1,5 @@
 
 #include <cstdint>
-#include <functional>
 #include <list>
 #include <map>
 #include <string>
@@ -8,6 +7,7 @@
 #include <type_traits>
 #include <utility>
 
+#include "lw/event/UniqueFunction.hpp"
 #include "lw/pp.hpp"
 #include "lw/trait.hpp"
 
@@ -69,7 +69,7 @@ template<typename... EventArgs>
 class Event {
 public:
     typedef std::tuple<EventArgs...> event_argument_types;      ///< The event arguments.
-    typedef std::function<void(EventArgs&&...)> listener_type;  ///< The type for storing listeners.
+    typedef UniqueFunction<void(EventArgs&&...)> listener_type; ///< The type for storing listeners.
 
     /// @brief Adds a new event listener to the back of the list.
     ///
@@ -217,7 +217,7 @@ public:
     /// @tparam EventId
     ///     The ID of the event to remove listeners from.
     /// @tparam Pred
-    ///     A functor type taking a const reference to a std::function for the listener and
+    ///     A functor type taking a const reference to the event's `listener_type` and
     ///     returning a boolean value.
     ///
     /// @param pred The functor to test every listener with.
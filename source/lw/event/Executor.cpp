@@ -0,0 +1,153 @@
+#include "lw/event/Executor.hpp"
+
+namespace lw {
+namespace event {
+
+/// @brief One of the executor's threads and its deque of tasks.
+struct Executor::_Worker {
+    _Worker(Executor& executor, const std::size_t index):
+        executor(executor),
+        index(index)
+    {}
+
+    Executor& executor;                         ///< The executor this thread belongs to.
+    std::size_t index;                          ///< The worker's position in the executor.
+    _details::WorkStealingDeque<_Task> tasks;   ///< Tasks posted from this thread.
+    std::thread thread;                         ///< The thread itself.
+};
+
+namespace {
+    /// @brief The executor thread running on the calling thread, if any.
+    thread_local void* t_worker = nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Executor::Executor(const std::size_t threads):
+    m_sleeping(0),
+    m_stopping(false)
+{
+    const std::size_t count = threads == 0 ? 1 : threads;
+    m_workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        m_workers.emplace_back(new _Worker(*this, i));
+    }
+
+    // Every worker must exist before any starts, since they steal from each other.
+    for (auto& worker : m_workers) {
+        _Worker* ptr = worker.get();
+        worker->thread = std::thread([this, ptr](){ _run(*ptr); });
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Executor::~Executor(void){
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Executor::_post(_Task* task){
+    _Worker* worker = (_Worker*)t_worker;
+    if (worker && &worker->executor == this) {
+        worker->tasks.push(task);
+
+        // Pairs with the fence in `_run` so either the sleeper sees the task or we see it asleep.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_injected.push_back(task);
+    }
+    m_wake.notify_one();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Executor::_run(_Worker& worker){
+    t_worker = (void*)&worker;
+    while (true) {
+        if (_Task* task = _find(worker)) {
+            std::unique_ptr<_Task> owned(task);
+            (*owned)();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_injected.empty()) {
+            continue;
+        }
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_has_work()) {
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (m_stopping) {
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        m_wake.wait(lock);
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+    t_worker = nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Executor::_Task* Executor::_find(_Worker& worker){
+    if (_Task* task = worker.tasks.take()) {
+        return task;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_injected.empty()) {
+            _Task* task = m_injected.front();
+            m_injected.pop_front();
+            return task;
+        }
+    }
+
+    // Start with the next worker along so thieves spread out over their victims.
+    const std::size_t count = m_workers.size();
+    for (std::size_t i = 1; i < count; ++i) {
+        if (_Task* task = m_workers[(worker.index + i) % count]->tasks.steal()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+bool Executor::_has_work(void){
+    if (!m_injected.empty()) {
+        return true;
+    }
+    for (auto& worker : m_workers) {
+        if (!worker->tasks.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+}
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lw/error.hpp"
+#include "lw/event/Loop.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+#include "lw/event/UniqueFunction.hpp"
+
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace _details {
+    /// @internal
+    /// @brief A Chase-Lev work-stealing deque of pointers.
+    ///
+    /// The owning thread pushes and takes at the bottom, any other thread may steal from the top.
+    /// The buffer grows as needed, and buffers which have been replaced are kept until the deque
+    /// is destroyed since a thief may still be reading from one.
+    ///
+    /// @tparam T The pointed-to type.
+    template<typename T>
+    class WorkStealingDeque {
+    public:
+        explicit WorkStealingDeque(const std::size_t capacity = 64):
+            m_top(0),
+            m_bottom(0),
+            m_buffer(new _Buffer(capacity))
+        {
+            m_buffers.emplace_back(m_buffer.load(std::memory_order_relaxed));
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Adds an item to the bottom, only called by the owning thread.
+        void push(T* item){
+            const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const std::int64_t top = m_top.load(std::memory_order_acquire);
+            _Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+            if (bottom - top >= (std::int64_t)buffer->size()) {
+                buffer = _grow(buffer, top, bottom);
+            }
+            buffer->put(bottom, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Removes the item at the bottom, only called by the owning thread.
+        ///
+        /// @return The most recently pushed item, or `nullptr` if there are none.
+        T* take(void){
+            const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            _Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = buffer->get(bottom);
+            if (top == bottom) {
+                // Last item, race any thieves for it.
+                if (!m_top.compare_exchange_strong(
+                    top,
+                    top + 1,
+                    std::memory_order_seq_cst,
+                    std::memory_order_relaxed
+                )) {
+                    item = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Removes the item at the top, may be called by any thread.
+        ///
+        /// @return The least recently pushed item, or `nullptr` if there are none or another
+        ///         thread took it first.
+        T* steal(void){
+            std::int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom) {
+                return nullptr;
+            }
+
+            T* item = m_buffer.load(std::memory_order_acquire)->get(top);
+            if (!m_top.compare_exchange_strong(
+                top,
+                top + 1,
+                std::memory_order_seq_cst,
+                std::memory_order_relaxed
+            )) {
+                return nullptr;
+            }
+            return item;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Indicates if the deque looked empty at some point during the call.
+        bool empty(void) const {
+            return m_bottom.load(std::memory_order_relaxed)
+                <= m_top.load(std::memory_order_relaxed);
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    private:
+        /// @brief A ring buffer of items indexed by their position in the deque.
+        class _Buffer {
+        public:
+            explicit _Buffer(const std::size_t size):
+                m_mask(size - 1),
+                m_items(new std::atomic<T*>[size])
+            {}
+
+            std::size_t size(void) const {
+                return m_mask + 1;
+            }
+
+            void put(const std::int64_t index, T* item){
+                m_items[index & m_mask].store(item, std::memory_order_relaxed);
+            }
+
+            T* get(const std::int64_t index) const {
+                return m_items[index & m_mask].load(std::memory_order_relaxed);
+            }
+
+        private:
+            std::size_t m_mask;                         ///< Size minus one, sizes are powers of 2.
+            std::unique_ptr<std::atomic<T*>[]> m_items; ///< The items.
+        };
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Replaces the buffer with one twice its size.
+        _Buffer* _grow(_Buffer* buffer, const std::int64_t top, const std::int64_t bottom){
+            _Buffer* grown = new _Buffer(buffer->size() * 2);
+            for (std::int64_t i = top; i < bottom; ++i) {
+                grown->put(i, buffer->get(i));
+            }
+            m_buffers.emplace_back(grown);
+            m_buffer.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        std::atomic<std::int64_t> m_top;                    ///< Position of the next steal.
+        std::atomic<std::int64_t> m_bottom;                 ///< Position of the next push.
+        std::atomic<_Buffer*> m_buffer;                     ///< The current buffer.
+        std::vector<std::unique_ptr<_Buffer>> m_buffers;    ///< Every buffer, kept for thieves.
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief A pool of threads for CPU-bound work, separate from libuv's threadpool.
+///
+/// Each thread keeps its own deque of tasks. Tasks posted from one of the executor's threads go on
+/// that thread's deque and are run newest first, while idle threads steal the oldest tasks from the
+/// others. Tasks posted from any other thread go on a shared queue. Keeping this work off of
+/// libuv's threadpool means it cannot hold up file I/O, and file I/O cannot hold it up.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::event::Executor cpu;
+///     lw::io::open(loop, path).then([](std::shared_ptr<lw::io::File>&& file){
+///         return file->read(1 << 20);
+///     }).then_on(cpu, [](lw::memory::Buffer&& contents){
+///         return parse(contents);     // On one of cpu's threads.
+///     }).then([](Document&& document){
+///         // Back on the loop.
+///     });
+/// @endcode
+class Executor {
+public:
+    /// @brief Starts the executor's threads.
+    ///
+    /// @param threads The number of threads, defaulting to the number of hardware threads.
+    explicit Executor(const std::size_t threads = std::thread::hardware_concurrency());
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /// @brief Runs every task already posted, then stops the threads.
+    ~Executor(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of threads in the executor.
+    std::size_t size(void) const {
+        return m_workers.size();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls a functor on one of the executor's threads.
+    ///
+    /// This may be called from any thread. The functor must not throw.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func The functor to call.
+    template<typename Func>
+    void post(Func&& func){
+        _post(new _Task(std::forward<Func>(func)));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls a functor on one of the executor's threads and delivers its result back on the
+    /// calling thread's loop.
+    ///
+    /// If the functor throws the future is rejected with the exception, wrapped in an
+    /// `error::ForeignException` if it is not an `error::Exception`. The loop is kept running until
+    /// the result arrives.
+    ///
+    /// This must be called from a thread with a loop, see `Loop::current`.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func The functor to call.
+    ///
+    /// @return A future for the functor's result.
+    template<typename Func>
+    Future<_details::WorkResult<Func>> submit(Func&& func){
+        typedef _details::WorkResult<Func> result_type;
+
+        Promise<result_type> promise(*Loop::current());
+        auto future = promise.future();
+        post([promise = std::move(promise), func = std::forward<Func>(func)]() mutable {
+            try {
+                _resolve(promise, func, std::is_void<result_type>());
+            }
+            catch (...) {
+                // Nothing may escape onto the worker thread, so foreign exceptions are wrapped.
+                promise.reject(error::Error::current());
+            }
+        });
+        return future;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    typedef UniqueFunction<void(void)> _Task;
+
+    struct _Worker;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    template<typename T, typename Func>
+    static void _resolve(Promise<T>& promise, Func& func, std::false_type){
+        promise.resolve(func());
+    }
+
+    template<typename Func>
+    static void _resolve(Promise<>& promise, Func& func, std::true_type){
+        func();
+        promise.resolve();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Queues a task, on the calling thread's deque if it is one of ours.
+    void _post(_Task* task);
+
+    /// @brief Runs tasks on one of the executor's threads until the executor stops.
+    void _run(_Worker& worker);
+
+    /// @brief Finds a task for the worker, from its own deque, the shared queue, or another
+    /// worker's deque.
+    _Task* _find(_Worker& worker);
+
+    /// @brief Indicates if any task is queued anywhere, called with `m_mutex` held.
+    bool _has_work(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    std::vector<std::unique_ptr<_Worker>> m_workers;    ///< The executor's threads.
+    std::mutex m_mutex;                                 ///< Guards `m_injected` and sleeping.
+    std::condition_variable m_wake;                     ///< Wakes sleeping threads.
+    std::deque<_Task*> m_injected;                      ///< Tasks posted from other threads.
+    std::atomic<std::size_t> m_sleeping;                ///< Number of threads waiting for work.
+    bool m_stopping;                                    ///< Flag indicating threads should exit.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename T>
+template<typename Func>
+auto Future<T>::then_on(Executor& executor, Func&& func){
+    return then([&executor, func = std::forward<Func>(func)](T&& value) mutable {
+        return executor.submit([func = std::move(func), value = std::move(value)]() mutable {
+            return func(std::move(value));
+        });
+    });
+}
+
+template<typename Func>
+auto Future<void>::then_on(Executor& executor, Func&& func){
+    return then([&executor, func = std::forward<Func>(func)]() mutable {
+        return executor.submit(std::move(func));
+    });
+}
+
+}
+}
@@ -0,0 +1,62 @@
+
+#include <uv.h>
+
+#include "lw/event/HandlePool.hpp"
+
+namespace lw {
+namespace event {
+
+namespace {
+    typedef void* (*allocate_func)(void);
+    typedef void (*deallocate_func)(void*);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void* HandlePool::allocate(const std::size_t size){
+    static const allocate_func allocators[] = {
+        &_Pool<1>::allocate, &_Pool<2>::allocate, &_Pool<3>::allocate, &_Pool<4>::allocate,
+        &_Pool<5>::allocate, &_Pool<6>::allocate, &_Pool<7>::allocate, &_Pool<8>::allocate
+    };
+    static_assert(
+        sizeof(allocators) / sizeof(*allocators) == class_count,
+        "Every size class needs an entry."
+    );
+
+    const std::size_t size_class = _size_class(size);
+    if (size_class == 0 || size_class > class_count) {
+        return ::operator new(size);
+    }
+    return allocators[size_class - 1]();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void HandlePool::deallocate(void* ptr, const std::size_t size){
+    static const deallocate_func deallocators[] = {
+        &_Pool<1>::deallocate, &_Pool<2>::deallocate, &_Pool<3>::deallocate, &_Pool<4>::deallocate,
+        &_Pool<5>::deallocate, &_Pool<6>::deallocate, &_Pool<7>::deallocate, &_Pool<8>::deallocate
+    };
+    static_assert(
+        sizeof(deallocators) / sizeof(*deallocators) == class_count,
+        "Every size class needs an entry."
+    );
+
+    const std::size_t size_class = _size_class(size);
+    if (size_class == 0 || size_class > class_count) {
+        ::operator delete(ptr);
+        return;
+    }
+    deallocators[size_class - 1](ptr);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void HandlePool::close(uv_handle_s* handle){
+    uv_close(handle, [](uv_handle_t* handle){
+        deallocate(handle, uv_handle_size(handle->type));
+    });
+}
+
+}
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include "lw/memory/FreeList.hpp"
+
+struct uv_handle_s;
+
+namespace lw {
+namespace event {
+
+/// @brief Thread-local size-class pools for libuv handles and requests.
+///
+/// Every handle and request type is served from the pool for its size rounded up to a multiple of
+/// `HandlePool::granularity`, so types of a similar size share their blocks. Each loop runs on its
+/// own thread and so draws from its own set of pools, without any locking.
+///
+/// Blocks must only be given back once libuv is done with them. For requests that is from their
+/// completion callback, for handles that is from their close callback which `HandlePool::close`
+/// takes care of.
+///
+/// @par Example
+/// @code{.cpp}
+///     uv_timer_t* timer = event::HandlePool::allocate<uv_timer_t>();
+///     uv_timer_init(loop.lowest_layer(), timer);
+///     // ...
+///     event::HandlePool::close((uv_handle_t*)timer);
+/// @endcode
+class HandlePool {
+public:
+    /// @brief The size classes are spaced this many bytes apart.
+    static constexpr std::size_t granularity = 64;
+
+    /// @brief The largest block served from a pool, anything bigger uses the global allocator.
+    static constexpr std::size_t max_size = 512;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Takes an uninitialized block for a `T` from the pool for its size.
+    ///
+    /// @tparam T The libuv handle or request type to allocate.
+    template<typename T>
+    static T* allocate(void){
+        return static_cast<T*>(_Pool<_size_class(sizeof(T))>::allocate());
+    }
+
+    /// @brief Takes an uninitialized block of at least `size` bytes from the pool for that size.
+    ///
+    /// @param size The number of bytes needed.
+    static void* allocate(const std::size_t size);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Returns a block taken with `HandlePool::allocate<T>` to its pool.
+    ///
+    /// @tparam T The libuv handle or request type the block was allocated for.
+    ///
+    /// @param ptr The block to return.
+    template<typename T>
+    static void deallocate(T* ptr){
+        _Pool<_size_class(sizeof(T))>::deallocate(ptr);
+    }
+
+    /// @brief Returns a block taken with `HandlePool::allocate` to its pool.
+    ///
+    /// @param ptr  The block to return.
+    /// @param size The size the block was allocated with.
+    static void deallocate(void* ptr, const std::size_t size);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Closes the handle and returns it to its pool once libuv has finished closing it.
+    ///
+    /// @param handle A handle allocated from the pool.
+    static void close(uv_handle_s* handle);
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    /// @brief The number of pooled size classes.
+    static constexpr std::size_t class_count = max_size / granularity;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Maps a size in bytes to its size class, starting at 1.
+    static constexpr std::size_t _size_class(const std::size_t size){
+        return (size + granularity - 1) / granularity;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The storage for a block in the given size class.
+    template<std::size_t Class>
+    struct alignas(std::max_align_t) _Block {
+        unsigned char bytes[Class * granularity];
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The pool for a size class, or the global allocator for sizes past `max_size`.
+    template<std::size_t Class, bool Pooled = (Class <= class_count)>
+    struct _Pool {
+        static void* allocate(void){
+            return memory::FreeList<_Block<Class>>::allocate();
+        }
+
+        static void deallocate(void* ptr){
+            memory::FreeList<_Block<Class>>::deallocate(ptr);
+        }
+    };
+
+    template<std::size_t Class>
+    struct _Pool<Class, false> {
+        static void* allocate(void){
+            return ::operator new(Class * granularity);
+        }
+
+        static void deallocate(void* ptr){
+            ::operator delete(ptr);
+        }
+    };
+};
+
+}
+}
@@ -1,14 +1,14 @@
 
-#include <cstdlib>
 #include <uv.h>
 
+#include "lw/event/HandlePool.hpp"
 #include "lw/event/Idle.hpp"
 
 namespace lw {
 namespace event {
 
 Idle::Idle( Loop& loop ):
-    m_handle( (uv_idle_s*)std::malloc( sizeof( uv_idle_s ) ) ),
+    m_handle( HandlePool::allocate< uv_idle_s >() ),
     m_callback( nullptr ),
     m_started( false )
 {
@@ -18,7 +18,7 @@ Idle::Idle( Loop& loop ):
 
 Idle::~Idle( void ){
     stop();
-    std::free( m_handle );
+    HandlePool::close( (uv_handle_t*)m_handle );
 }
 
 void Idle::start( void ){
@@ -1,9 +1,9 @@
 #pragma once
 
 #include <atomic>
-#include <functional>
 
 #include "lw/event/Loop.hpp"
+#include "lw/event/UniqueFunction.hpp"
 
 struct uv_idle_s;
 
@@ -12,7 +12,7 @@ namespace event {
 
 class Idle {
 public:
-    typedef std::function< void( void ) > Callback;
+    typedef UniqueFunction< void( void ) > Callback;
 
     Idle( Loop& loop );
 
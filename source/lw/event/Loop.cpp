@@ -1,21 +1,107 @@
-
+#include <chrono>
 #include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <string>
 #include <uv.h>
 
+#include "lw/event/HandlePool.hpp"
 #include "lw/event/Loop.hpp"
+#include "lw/event/TimerWheel.hpp"
 
 namespace lw {
 namespace event {
 
 Loop::Loop(void):
-    m_loop((uv_loop_s*)std::malloc(sizeof(uv_loop_s)))
+    m_loop((uv_loop_s*)std::malloc(sizeof(uv_loop_s))),
+    m_thread(std::this_thread::get_id()),
+    m_microtasks(new _Microtasks()),
+    m_remote(new _Remote()),
+    m_deadline(HandlePool::allocate<uv_timer_s>())
 {
     uv_loop_init(m_loop);
+    if (!_current()) {
+        _current() = this;
+    }
+
+#ifdef LW_ENABLE_EVENT_STATS
+    m_stats = std::make_shared<_details::StatsCounters>();
+    m_previous_stats = std::move(_details::StatsCounters::current());
+    _details::StatsCounters::current() = m_stats;
+#endif
+
+    m_microtasks->check = HandlePool::allocate<uv_check_s>();
+    m_microtasks->idle  = HandlePool::allocate<uv_idle_s>();
+    m_microtasks->armed = false;
+    m_microtasks->budget = std::chrono::nanoseconds::max();
+    uv_check_init(m_loop, m_microtasks->check);
+    uv_idle_init(m_loop, m_microtasks->idle);
+    m_microtasks->check->data = (void*)m_microtasks.get();
+
+    // The async handle only keeps the loop alive while something is expected from another thread.
+    m_remote->head          = nullptr;
+    m_remote->pending       = nullptr;
+    m_remote->microtasks    = m_microtasks.get();
+    m_remote->signalled     = false;
+    m_remote->closed        = false;
+    m_remote->references    = 1;
+    m_remote->keep_alive    = 0;
+    m_remote->async         = HandlePool::allocate<uv_async_s>();
+    uv_async_init(m_loop, m_remote->async, [](uv_async_t* handle){
+        _run_remote(*(_Remote*)handle->data);
+    });
+    m_remote->async->data = (void*)m_remote;
+    uv_unref((uv_handle_t*)m_remote->async);
+
+    // The deadline for `run_for` only ever stops the loop, it never keeps it running.
+    uv_timer_init(m_loop, m_deadline);
+    uv_unref((uv_handle_t*)m_deadline);
 }
 
 // ---------------------------------------------------------------------------------------------- //
 
 Loop::~Loop(void){
+    if (_current() == this) {
+        _current() = nullptr;
+    }
+#ifdef LW_ENABLE_EVENT_STATS
+    if (m_stats && _details::StatsCounters::current() == m_stats) {
+        _details::StatsCounters::current() = std::move(m_previous_stats);
+    }
+#endif
+
+    if (!m_loop) {
+        return;
+    }
+
+    // Turn away new posts and wait out any still pushing or signalling, which takes a moment at
+    // most, before the async handle goes away under them.
+    m_remote->closed.store(true);
+    while (m_remote->references.load() > 1) {
+        std::this_thread::yield();
+    }
+
+    m_wheel.reset();
+    HandlePool::close((uv_handle_t*)m_microtasks->check);
+    HandlePool::close((uv_handle_t*)m_microtasks->idle);
+    HandlePool::close((uv_handle_t*)m_remote->async);
+    HandlePool::close((uv_handle_t*)m_deadline);
+    if (m_monitor) {
+        HandlePool::close((uv_handle_t*)m_monitor->prepare);
+        HandlePool::close((uv_handle_t*)m_monitor->check);
+    }
+    uv_run(m_loop, UV_RUN_NOWAIT);
+
+    // Anything still queued from other threads will never run now.
+    for (_RemoteTask* task : {m_remote->pending, m_remote->head.exchange(nullptr)}) {
+        while (task) {
+            _RemoteTask* next = task->next;
+            delete task;
+            task = next;
+        }
+    }
+    _release_remote(m_remote);
+
     uv_loop_close(m_loop);
     std::free(m_loop);
 }
@@ -23,7 +109,398 @@ Loop::~Loop(void){
 // ---------------------------------------------------------------------------------------------- //
 
 void Loop::run(void){
-    uv_run(m_loop, UV_RUN_DEFAULT);
+    _run(UV_RUN_DEFAULT);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+bool Loop::run_once(void){
+    return _run(UV_RUN_ONCE);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+bool Loop::run_nowait(void){
+    return _run(UV_RUN_NOWAIT);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+bool Loop::_run(const int mode){
+    m_thread = std::this_thread::get_id();
+    Loop* previous = _current();
+    _current() = this;
+#ifdef LW_ENABLE_EVENT_STATS
+    auto previous_stats = _details::StatsCounters::current();
+    _details::StatsCounters::current() = m_stats;
+#endif
+
+    if (m_monitor) {
+        // Time spent outside of `run` is not part of any iteration.
+        m_monitor->iteration_started = _Monitor::clock::now();
+    }
+    const bool alive = uv_run(m_loop, (uv_run_mode)mode) != 0;
+    _current() = previous;
+
+#ifdef LW_ENABLE_EVENT_STATS
+    m_stats->unresolved_at_exit = m_stats->pending_states.load();
+    _details::StatsCounters::current() = std::move(previous_stats);
+#endif
+    return alive;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+bool Loop::_run_for(const std::uint64_t milliseconds){
+    uv_timer_start(m_deadline, [](uv_timer_t* handle){ uv_stop(handle->loop); }, milliseconds, 0);
+    const bool alive = _run(UV_RUN_DEFAULT);
+    uv_timer_stop(m_deadline);
+    return alive;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::set_threadpool_size(const std::size_t size){
+    // libuv reads this once, when the threadpool is started.
+#ifdef _WIN32
+    _putenv_s("UV_THREADPOOL_SIZE", std::to_string(size).c_str());
+#else
+    setenv("UV_THREADPOOL_SIZE", std::to_string(size).c_str(), 1);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::monitor_iterations(void){
+    if (m_monitor) {
+        return;
+    }
+
+#if defined(UV_VERSION_HEX) && UV_VERSION_HEX >= 0x012700
+    // Lets waiting in the poll be told apart from the I/O callbacks it runs.
+    uv_loop_configure(m_loop, UV_METRICS_IDLE_TIME);
+#endif
+
+    m_monitor.reset(new _Monitor());
+    m_monitor->prepare           = HandlePool::allocate<uv_prepare_s>();
+    m_monitor->check             = HandlePool::allocate<uv_check_s>();
+    m_monitor->iteration_started = _Monitor::clock::now();
+    m_monitor->idle_at_poll      = 0;
+    m_monitor->iterations        = 0;
+    m_monitor->running           = _Monitor::clock::duration(0);
+    m_monitor->waiting           = _Monitor::clock::duration(0);
+    m_monitor->lag_threshold     = _Monitor::clock::duration::max();
+
+    uv_prepare_init(m_loop, m_monitor->prepare);
+    uv_check_init(m_loop, m_monitor->check);
+    m_monitor->prepare->data = (void*)m_monitor.get();
+    m_monitor->check->data   = (void*)m_monitor.get();
+    uv_prepare_start(m_monitor->prepare, [](uv_prepare_t* handle){
+        _monitor_prepare(*(_Monitor*)handle->data, handle->loop);
+    });
+    uv_check_start(m_monitor->check, [](uv_check_t* handle){
+        _monitor_check(*(_Monitor*)handle->data, handle->loop);
+    });
+    uv_unref((uv_handle_t*)m_monitor->prepare);
+    uv_unref((uv_handle_t*)m_monitor->check);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+IterationStats Loop::iteration_stats(void) const {
+    IterationStats stats;
+    stats.iterations            = 0;
+    stats.iterations_per_second = 0.0;
+    stats.poll_time             = std::chrono::nanoseconds(0);
+    stats.callback_time         = std::chrono::nanoseconds(0);
+    if (!m_monitor) {
+        return stats;
+    }
+
+    stats.iterations    = m_monitor->iterations;
+    stats.poll_time     = std::chrono::duration_cast<std::chrono::nanoseconds>(m_monitor->waiting);
+    stats.callback_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        m_monitor->running - m_monitor->waiting
+    );
+    stats.callback_phase = m_monitor->busy;
+
+    std::chrono::duration<double> running = m_monitor->running;
+    stats.iterations_per_second = running.count() > 0 ? stats.iterations / running.count() : 0.0;
+    return stats;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::on_lag(
+    const std::chrono::nanoseconds threshold,
+    UniqueFunction<void(std::chrono::nanoseconds)> callback
+){
+    monitor_iterations();
+    m_monitor->lag_threshold     = threshold;
+    m_monitor->on_lag            = std::move(callback);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::use_timer_wheel(void){
+    if (!m_wheel) {
+        m_wheel.reset(new TimerWheel(*this));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_WheelDeleter::operator()(TimerWheel* wheel) const {
+    delete wheel;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_monitor_prepare(_Monitor& monitor, uv_loop_s* loop){
+    monitor.poll_started = _Monitor::clock::now();
+#if defined(UV_VERSION_HEX) && UV_VERSION_HEX >= 0x012700
+    monitor.idle_at_poll = uv_metrics_idle_time(loop);
+#else
+    (void)loop;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_monitor_check(_Monitor& monitor, uv_loop_s* loop){
+    const auto now = _Monitor::clock::now();
+#if defined(UV_VERSION_HEX) && UV_VERSION_HEX >= 0x012700
+    const _Monitor::clock::duration waited = std::chrono::duration_cast<_Monitor::clock::duration>(
+        std::chrono::nanoseconds(uv_metrics_idle_time(loop) - monitor.idle_at_poll)
+    );
+#else
+    (void)loop;
+    const _Monitor::clock::duration waited = now - monitor.poll_started;
+#endif
+
+    const auto length = now - monitor.iteration_started;
+    const auto busy = length > waited ? length - waited : _Monitor::clock::duration(0);
+    monitor.iteration_started = now;
+    ++monitor.iterations;
+    monitor.running += length;
+    monitor.waiting += length > waited ? waited : length;
+    monitor.busy.record(busy);
+
+    if (busy > monitor.lag_threshold && monitor.on_lag) {
+        monitor.on_lag(std::chrono::duration_cast<std::chrono::nanoseconds>(busy));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Loop*& Loop::_current(void){
+    static thread_local Loop* current = nullptr;
+    return current;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_arm_microtasks(_Microtasks& tasks){
+    tasks.armed = true;
+    uv_check_start(tasks.check, [](uv_check_t* handle){
+        _run_microtasks(*(_Microtasks*)handle->data);
+    });
+
+    // An active idle handle makes the loop poll without blocking, so the check runs promptly.
+    uv_idle_start(tasks.idle, [](uv_idle_t*){});
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_run_microtasks(_Microtasks& tasks){
+    typedef std::chrono::steady_clock clock;
+    const bool budgeted = tasks.budget != std::chrono::nanoseconds::max();
+    const clock::time_point deadline = budgeted
+        ? clock::now() + std::chrono::duration_cast<clock::duration>(tasks.budget)
+        : clock::time_point::max();
+
+    // Leaves the handles running exactly while tasks are waiting, even if a task throws.
+    struct ArmGuard {
+        ~ArmGuard(void){
+            bool pending = false;
+            for (const auto& queue : tasks.queue) {
+                pending = pending || !queue.empty();
+            }
+            if (pending) {
+                _arm_microtasks(tasks);
+            }
+            else {
+                tasks.armed = false;
+                uv_check_stop(tasks.check);
+                uv_idle_stop(tasks.idle);
+            }
+        }
+
+        _Microtasks& tasks;
+    } arm_guard{tasks};
+
+    for (std::size_t lane = 0; lane < priority_count; ++lane) {
+        auto& queue = tasks.queue[lane];
+        tasks.running.swap(queue);
+
+        // Drops the tasks which have run and puts whatever is left back ahead of the tasks deferred
+        // since, including when a task throws, so none are run twice or lost.
+        std::size_t ran = 0;
+        struct LaneGuard {
+            ~LaneGuard(void){
+                if (ran < tasks.running.size()) {
+                    queue.insert(
+                        queue.begin(),
+                        std::make_move_iterator(tasks.running.begin() + ran),
+                        std::make_move_iterator(tasks.running.end())
+                    );
+                }
+                tasks.running.clear();
+            }
+
+            _Microtasks& tasks;
+            std::vector<_Microtask>& queue;
+            const std::size_t& ran;
+        } lane_guard{tasks, queue, ran};
+
+        // Lower lanes always get to run one task, however much of the budget is gone.
+        const bool limited = budgeted && lane != (std::size_t)Priority::HIGH;
+        while (
+            ran < tasks.running.size() &&
+            (ran == 0 || !limited || clock::now() < deadline)
+        ) {
+            tasks.running[ran++]();
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_push_remote(_RemoteTask* task){
+    // Once the task is pushed the loop may run it and be destroyed at any moment, so only the
+    // referenced remote block is touched from here on.
+    _Remote* remote = m_remote;
+    remote->references.fetch_add(1);
+    if (remote->closed.load()) {
+        _release_remote(remote);
+        delete task;
+        return;
+    }
+
+    _RemoteTask* head = remote->head.load(std::memory_order_relaxed);
+    do {
+        task->next = head;
+    } while (!remote->head.compare_exchange_weak(
+        head,
+        task,
+        std::memory_order_release,
+        std::memory_order_relaxed
+    ));
+
+    if (!remote->signalled.exchange(true, std::memory_order_acq_rel)) {
+        uv_async_send(remote->async);
+    }
+    _release_remote(remote);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_release_remote(_Remote* remote){
+    if (remote->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete remote;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_run_remote(_Remote& remote){
+    // Clear the signal before taking the tasks so any pushed after this point send a new wakeup.
+    remote.signalled.store(false, std::memory_order_seq_cst);
+    _RemoteTask* task = remote.head.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack is newest first, reverse it to run the tasks in the order they were sent.
+    _RemoteTask* ordered = nullptr;
+    while (task) {
+        _RemoteTask* next = task->next;
+        task->next = ordered;
+        ordered = task;
+        task = next;
+    }
+
+    // Tasks left over from a drain which threw were sent before any of these.
+    if (remote.pending) {
+        _RemoteTask* last = remote.pending;
+        while (last->next) {
+            last = last->next;
+        }
+        last->next = ordered;
+        ordered = remote.pending;
+        remote.pending = nullptr;
+    }
+
+    // If a task throws, the rest are kept for another wakeup so their promises still settle and
+    // the keep-alive references they release are not lost.
+    struct DrainGuard {
+        ~DrainGuard(void){
+            if (ordered) {
+                remote.pending = ordered;
+                remote.signalled.store(true, std::memory_order_seq_cst);
+                uv_async_send(remote.async);
+            }
+        }
+
+        _Remote& remote;
+        _RemoteTask*& ordered;
+    } guard{remote, ordered};
+
+    while (ordered) {
+        std::unique_ptr<_RemoteTask> current(ordered);
+        ordered = ordered->next;
+        if (!current->deferred) {
+            current->task();
+            continue;
+        }
+
+        _Microtasks& tasks = *remote.microtasks;
+        if (!tasks.armed) {
+            _arm_microtasks(tasks);
+        }
+        tasks.queue[(std::size_t)current->priority].push_back(std::move(current->task));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_queue_work(_details::WorkTask* task){
+    uv_work_t* request = HandlePool::allocate<uv_work_t>();
+    request->data = (void*)task;
+    uv_queue_work(m_loop, request, [](uv_work_t* request){
+        ((_details::WorkTask*)request->data)->run();
+    }, [](uv_work_t* request, int status){
+        std::unique_ptr<_details::WorkTask> task((_details::WorkTask*)request->data);
+        HandlePool::deallocate(request);
+        task->done(status);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_add_keep_alive(void){
+    if (m_remote->keep_alive++ == 0) {
+        uv_ref((uv_handle_t*)m_remote->async);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Loop::_release_keep_alive(void){
+    if (!is_loop_thread()) {
+        post([this](){ _release_keep_alive(); });
+        return;
+    }
+    if (--m_remote->keep_alive == 0) {
+        uv_unref((uv_handle_t*)m_remote->async);
+    }
 }
 
 }
@@ -1,10 +1,81 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lw/error/Exception.hpp"
+#include "lw/event/Stats.hpp"
+#include "lw/event/UniqueFunction.hpp"
+
+struct uv_async_s;
+struct uv_check_s;
+struct uv_idle_s;
 struct uv_loop_s;
+struct uv_prepare_s;
+struct uv_timer_s;
 
 namespace lw {
+
+class LoopGroup;
+
 namespace event {
 
+LW_DEFINE_EXCEPTION(WorkError);
+
+template<typename T>
+class Future;
+
+class TimerWheel;
+
+namespace _details {
+    template<typename T>
+    class SharedState;
+
+    /// @internal
+    /// @brief The type returned by a functor given to `Loop::queue_work`.
+    template<typename Func>
+    using WorkResult = decltype(std::declval<typename std::decay<Func>::type&>()());
+
+    /// @internal
+    /// @brief A task for the threadpool, whose outcome is handed back to the loop.
+    class WorkTask {
+    public:
+        virtual ~WorkTask(void){}
+
+        /// @brief Does the work, called on a threadpool thread.
+        virtual void run(void) = 0;
+
+        /// @brief Delivers the outcome, called on the loop's thread.
+        ///
+        /// @param status Zero if the work ran, or the error which stopped it from running.
+        virtual void done(const int status) = 0;
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief The lanes deferred tasks, posted tasks and continuations can be scheduled in.
+///
+/// Each iteration the loop runs the tasks in the higher lanes first. See `Loop::task_budget` for
+/// how lower lanes are kept from starving.
+enum class Priority {
+    HIGH    = 0,    ///< Latency sensitive work such as health checks and interactive requests.
+    NORMAL  = 1,    ///< Everything not given a priority.
+    LOW     = 2     ///< Background work such as flushes and bulk exports.
+};
+
+/// @brief The number of `Priority` lanes.
+constexpr std::size_t priority_count = 3;
+
+// ---------------------------------------------------------------------------------------------- //
+
 /// @brief The event loop which runs all tasks.
 class Loop {
 public:
@@ -16,8 +87,24 @@ public:
 
     /// @brief Move constructor.
     Loop(Loop&& other):
-        m_loop(other.m_loop)
-    {}
+        m_loop(other.m_loop),
+        m_thread(other.m_thread.load()),
+        m_microtasks(std::move(other.m_microtasks)),
+        m_remote(other.m_remote),
+        m_deadline(other.m_deadline),
+        m_monitor(std::move(other.m_monitor)),
+        m_wheel(std::move(other.m_wheel))
+#ifdef LW_ENABLE_EVENT_STATS
+        , m_stats(std::move(other.m_stats))
+        , m_previous_stats(std::move(other.m_previous_stats))
+#endif
+    {
+        other.m_loop = nullptr;
+        other.m_remote = nullptr;
+        if (_current() == &other) {
+            _current() = this;
+        }
+    }
 
     // ------------------------------------------------------------------------------------------ //
 
@@ -35,6 +122,276 @@ public:
 
     // ------------------------------------------------------------------------------------------ //
 
+    /// @brief Runs a single iteration of the loop, waiting for I/O if nothing is ready.
+    ///
+    /// @return True if the loop still has work, false if it has none left.
+    bool run_once(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs a single iteration of the loop without waiting for I/O.
+    ///
+    /// This suits embedding the loop in a frame-driven host which polls it once per frame.
+    ///
+    /// @return True if the loop still has work, false if it has none left.
+    bool run_nowait(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs the loop until the time has passed or it has no work left.
+    ///
+    /// The limit is checked between iterations, so a single slow task can overrun it. It has
+    /// millisecond resolution, and partial milliseconds are rounded up.
+    ///
+    /// @param budget How long to run for.
+    ///
+    /// @return True if the loop still has work, false if it has none left.
+    template<typename Rep, typename Period>
+    bool run_for(const std::chrono::duration<Rep, Period>& budget){
+        auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(budget);
+        if (milliseconds < budget) {
+            ++milliseconds;
+        }
+        return _run_for(milliseconds.count() < 0 ? 0 : (std::uint64_t)milliseconds.count());
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs the loop until the future is resolved or rejected.
+    ///
+    /// Returns as soon as the outcome reaches the future, so a continuation chained onto it
+    /// afterwards is called immediately. The future must not have a continuation already.
+    ///
+    /// @param future The future to wait for.
+    ///
+    /// @return True if the future is finished, false if the loop ran out of work first.
+    template<typename T>
+    bool run_until(Future<T>& future);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Schedules a functor to be called on the next iteration of the loop.
+    ///
+    /// Deferred functors are queued together and all of the ones queued before an iteration
+    /// starts are called in order once that iteration has finished polling for I/O. Functors
+    /// deferred while the queue is being run are called on the following iteration. Pending
+    /// functors keep the loop alive.
+    ///
+    /// This must only be called from the thread running the loop.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func The functor to call.
+    template<typename Func>
+    void defer(Func&& func){
+        defer(std::forward<Func>(func), Priority::NORMAL);
+    }
+
+    /// @brief Schedules a functor to be called on the next iteration in the given lane.
+    ///
+    /// Each iteration runs the deferred functors of every lane, highest first, and in order within
+    /// each lane.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func     The functor to call.
+    /// @param priority The lane to queue the functor in.
+    template<typename Func>
+    void defer(Func&& func, const Priority priority){
+        if (!m_microtasks->armed) {
+            _arm_microtasks(*m_microtasks);
+        }
+        m_microtasks->queue[(std::size_t)priority].emplace_back(std::forward<Func>(func));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Limits the time spent on deferred tasks in the lower lanes each iteration.
+    ///
+    /// The `Priority::HIGH` lane is always run in full. Once an iteration has spent the budget on
+    /// deferred tasks, the lower lanes run just one task each and the rest wait for the next
+    /// iteration, ahead of anything deferred since. Every lane therefore keeps making progress
+    /// while a busy higher lane cannot hold up I/O for long. The budget is unlimited by default.
+    ///
+    /// @param budget The time to spend on deferred tasks each iteration.
+    void task_budget(const std::chrono::nanoseconds budget){
+        m_microtasks->budget = budget;
+    }
+
+    /// @brief The time spent on deferred tasks in the lower lanes each iteration.
+    std::chrono::nanoseconds task_budget(void) const {
+        return m_microtasks->budget;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Sends a functor to be called on the loop's thread.
+    ///
+    /// This may be called from any thread. Tasks are pushed onto a lock-free queue and the loop is
+    /// woken with a single `uv_async_send` for however many arrive before it gets to them, then
+    /// runs them all in one batch. Tasks from the same thread run in the order they were posted.
+    ///
+    /// Posting does not keep the loop running by itself. Tasks posted while the loop is stopped
+    /// run the next time it is run, and tasks still queued when it is destroyed are dropped.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func The functor to call.
+    template<typename Func>
+    void post(Func&& func){
+        _push_remote(new _RemoteTask(std::forward<Func>(func)));
+    }
+
+    /// @brief Sends a functor to be deferred in the given lane on the loop's thread.
+    ///
+    /// The functor arrives with the rest of the batch and is then run like one given to `defer`,
+    /// in the same iteration.
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func     The functor to call.
+    /// @param priority The lane to queue the functor in.
+    template<typename Func>
+    void post(Func&& func, const Priority priority){
+        _RemoteTask* task = new _RemoteTask(std::forward<Func>(func));
+        task->deferred = true;
+        task->priority = priority;
+        _push_remote(task);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls a functor on the threadpool and delivers its result back on this loop.
+    ///
+    /// Use this for CPU-bound steps like hashing, compression or parsing, which would otherwise
+    /// hold up every other task on the loop. The functor must not touch the loop or anything else
+    /// owned by its thread. If it throws the future is rejected with the exception, wrapped in an
+    /// `error::ForeignException` if it is not an `error::Exception`, and if the work is cancelled
+    /// before it starts the future is rejected with a `WorkError`. Queued work keeps the loop alive.
+    ///
+    /// This must only be called from the thread running the loop, and the returned future must
+    /// be used on that thread too.
+    ///
+    /// @par Example
+    /// @code{.cpp}
+    ///     loop.queue_work([data = std::move(data)](){
+    ///         return sha256(data);
+    ///     }).then([](Digest&& digest){
+    ///         // Back on the loop.
+    ///     });
+    /// @endcode
+    ///
+    /// @tparam Func A functor type callable with no arguments.
+    ///
+    /// @param func The functor to call.
+    ///
+    /// @return A future for the functor's result.
+    template<typename Func>
+    Future<_details::WorkResult<Func>> queue_work(Func&& func);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Sets the number of threads in the threadpool used by `queue_work` and file I/O.
+    ///
+    /// The threadpool is shared by every loop in the process and is started the first time any
+    /// work is queued, after which its size is fixed. This must be called before any `queue_work`
+    /// or file system call on any loop, for example at the top of `main`; later calls are ignored.
+    /// It defaults to 4 threads.
+    ///
+    /// The size is passed to libuv through the environment, so this must not run while another
+    /// thread may be reading environment variables.
+    ///
+    /// @param size The number of threads.
+    static void set_threadpool_size(const std::size_t size);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The loop belonging to the calling thread.
+    ///
+    /// This is the loop being run on the calling thread or, when none is running, the first loop
+    /// constructed on the thread which still exists.
+    ///
+    /// @return The thread's loop, or `nullptr` if it has none.
+    static Loop* current(void){
+        return _current();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if the calling thread is the one running this loop.
+    ///
+    /// Before the loop is first run, the thread which constructed it is considered its thread.
+    bool is_loop_thread(void) const {
+        return m_thread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+#ifdef LW_ENABLE_EVENT_STATS
+    /// @brief Takes a snapshot of the promise statistics for this loop.
+    ///
+    /// Only available when built with `LW_ENABLE_EVENT_STATS` defined. Promises created on this
+    /// loop's thread while it is running, or while it is the most recently constructed loop on
+    /// that thread, are counted.
+    LoopStats stats(void) const {
+        return m_stats->snapshot();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+#endif
+
+    /// @brief Starts timing each iteration of the loop, see `iteration_stats`.
+    ///
+    /// Monitoring adds a prepare and a check handle which read the clock twice per iteration. The
+    /// handles do not keep the loop running. Calling this again has no effect.
+    void monitor_iterations(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Takes a snapshot of the iteration timings.
+    ///
+    /// Everything is zero unless `monitor_iterations` or `on_lag` has been called.
+    IterationStats iteration_stats(void) const;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls a functor whenever an iteration is busy running callbacks for too long.
+    ///
+    /// The functor is called on the loop's thread at the end of the offending iteration, with how
+    /// long the iteration was busy. This starts monitoring iterations if needed, and replaces any
+    /// functor given before.
+    ///
+    /// @par Example
+    /// @code{.cpp}
+    ///     loop.on_lag(50ms, [](std::chrono::nanoseconds blocked){
+    ///         log_warning("Event loop blocked for ", blocked.count(), "ns");
+    ///     });
+    /// @endcode
+    ///
+    /// @param threshold    The longest an iteration may be busy before it is reported.
+    /// @param callback     The functor to call.
+    void on_lag(
+        const std::chrono::nanoseconds threshold,
+        UniqueFunction<void(std::chrono::nanoseconds)> callback
+    );
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Switches `Timeout`, `wait` and `repeat` on this loop over to a `TimerWheel`.
+    ///
+    /// The wheel trades libuv's exact timer heap for constant time arming and cancelling with
+    /// far less memory per timer, which pays off with hundreds of thousands of pending deadlines
+    /// that are mostly cancelled. Timers started before the switch carry on as they were. Calling
+    /// this again has no effect.
+    void use_timer_wheel(void);
+
+    /// @brief The loop's timing wheel, or `nullptr` if `use_timer_wheel` has not been called.
+    TimerWheel* timer_wheel(void){
+        return m_wheel.get();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
     /// @brief Gives access to the native loop handle.
     uv_loop_s* lowest_layer(void){
         return m_loop;
@@ -42,7 +399,168 @@ public:
 
     // ------------------------------------------------------------------------------------------ //
 private:
+    template<typename T>
+    friend class _details::SharedState;
+
+    friend class ::lw::LoopGroup;
+
+    /// @brief Runs the loop in the given `uv_run_mode`.
+    ///
+    /// @return True if the loop still has work.
+    bool _run(const int mode);
+
+    /// @brief Runs the loop until the timeout or it has no work left.
+    bool _run_for(const std::uint64_t milliseconds);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The storage for `current`.
+    static Loop*& _current(void);
+
+    /// @brief Functor type for deferred tasks.
+    typedef UniqueFunction<void(void)> _Microtask;
+
+    /// @brief The queues of deferred tasks and the handles which run them.
+    struct _Microtasks {
+        std::vector<_Microtask> queue[priority_count];  ///< Tasks waiting, one queue per lane.
+        std::vector<_Microtask> running;                ///< Tasks being run from the current lane.
+        std::chrono::nanoseconds budget;                ///< The time lower lanes may take.
+        uv_check_s* check;                              ///< Runs the queues after polling.
+        uv_idle_s* idle;                                ///< Keeps polling from blocking.
+        bool armed;                                     ///< Flag indicating the handles run.
+    };
+
+    /// @brief A task sent to the loop from another thread.
+    struct _RemoteTask {
+        template<typename Func>
+        explicit _RemoteTask(Func&& func):
+            next(nullptr),
+            task(std::forward<Func>(func)),
+            deferred(false),
+            priority(Priority::NORMAL)
+        {}
+
+        _RemoteTask* next;  ///< The task pushed before this one.
+        _Microtask task;    ///< The functor to call on the loop.
+        bool deferred;      ///< Flag indicating the task goes into a lane rather than running.
+        Priority priority;  ///< The lane to defer the task in.
+    };
+
+    /// @brief Tasks sent from other threads and the handle which wakes the loop to run them.
+    ///
+    /// Producers push onto a lock-free stack, and the loop takes the whole stack in one exchange
+    /// and reverses it to restore order. Only the first push after the loop starts draining sends
+    /// a wakeup, so a burst of results costs a single `uv_async_send`.
+    ///
+    /// The loop may run a task and be destroyed before its producer has finished signalling, so
+    /// the block is reference counted. Producers hold a reference for the whole push and signal,
+    /// and the loop waits for them to let go before closing the handle.
+    struct _Remote {
+        std::atomic<_RemoteTask*> head;         ///< The most recently pushed task.
+        _RemoteTask* pending;                   ///< Tasks left over when one threw, oldest first.
+        _Microtasks* microtasks;                ///< The lanes to defer prioritized tasks into.
+        std::atomic_bool signalled;             ///< Flag indicating a wakeup is already pending.
+        std::atomic_bool closed;                ///< Flag indicating the loop is being destroyed.
+        std::atomic<std::size_t> references;    ///< The loop's reference and one per producer.
+        std::size_t keep_alive;                 ///< Outstanding reasons to keep the loop alive.
+        uv_async_s* async;                      ///< The handle used to wake the loop.
+    };
+
+    /// @brief Timings gathered by `monitor_iterations`.
+    struct _Monitor {
+        typedef std::chrono::steady_clock clock;
+
+        uv_prepare_s* prepare;                  ///< Marks the start of the poll.
+        uv_check_s* check;                      ///< Marks the end of the poll and the iteration.
+        clock::time_point iteration_started;    ///< When the current iteration began.
+        clock::time_point poll_started;         ///< When the current poll began.
+        std::uint64_t idle_at_poll;             ///< libuv's idle time when the poll began.
+        std::uint64_t iterations;               ///< Iterations measured.
+        clock::duration running;                ///< Total length of measured iterations.
+        clock::duration waiting;                ///< Total time waiting in poll.
+        LatencyHistogram busy;                  ///< Busy time of each iteration.
+        clock::duration lag_threshold;          ///< Busy time which counts as lag.
+
+        /// @brief Called when an iteration is busy for longer than `lag_threshold`.
+        UniqueFunction<void(std::chrono::nanoseconds)> on_lag;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Starts the handles that run deferred tasks.
+    static void _arm_microtasks(_Microtasks& tasks);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs the tasks queued before this call, lane by lane within the budget.
+    ///
+    /// @param tasks The task queue to run.
+    static void _run_microtasks(_Microtasks& tasks);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Records the start of a poll.
+    static void _monitor_prepare(_Monitor& monitor, uv_loop_s* loop);
+
+    /// @brief Records the end of a poll and of the iteration.
+    static void _monitor_check(_Monitor& monitor, uv_loop_s* loop);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Pushes the task onto the remote queue and wakes the loop if needed.
+    void _push_remote(_RemoteTask* task);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs every task sent from other threads.
+    ///
+    /// @param remote The remote task queue to run.
+    static void _run_remote(_Remote& remote);
+
+    /// @brief Drops a reference to the remote block, deleting it with the last one.
+    ///
+    /// @param remote The remote block to release.
+    static void _release_remote(_Remote* remote);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Hands a task to the threadpool.
+    ///
+    /// The loop takes ownership of the task and deletes it once its outcome is delivered.
+    void _queue_work(_details::WorkTask* task);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Keeps the loop running until a matching `_release_keep_alive`.
+    ///
+    /// This must only be called from the thread running the loop.
+    void _add_keep_alive(void);
+
+    /// @brief Releases a hold on the loop from `_add_keep_alive`.
+    ///
+    /// This may be called from any thread.
+    void _release_keep_alive(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Destroys the timing wheel, which is only a complete type in the source.
+    struct _WheelDeleter {
+        void operator()(TimerWheel* wheel) const;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
     uv_loop_s* m_loop;
+    std::atomic<std::thread::id> m_thread;
+    std::unique_ptr<_Microtasks> m_microtasks;
+    _Remote* m_remote;
+    uv_timer_s* m_deadline;
+    std::unique_ptr<_Monitor> m_monitor;
+    std::unique_ptr<TimerWheel, _WheelDeleter> m_wheel;
+#ifdef LW_ENABLE_EVENT_STATS
+    std::shared_ptr<_details::StatsCounters> m_stats;
+    std::shared_ptr<_details::StatsCounters> m_previous_stats;
+#endif
 };
 
 }
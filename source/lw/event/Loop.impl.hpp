@@ -0,0 +1,141 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "lw/error.hpp"
+#include "lw/event/Loop.hpp"
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace _details {
+    /// @internal
+    /// @brief Runs a functor on the threadpool and settles a promise with its outcome.
+    ///
+    /// The result is kept on the task until the loop picks it up, so the promise is only ever
+    /// touched on the loop's thread.
+    ///
+    /// @tparam Func The functor type to run.
+    template<typename Func>
+    class Work : public WorkTask {
+    public:
+        typedef WorkResult<Func> result_type;
+        typedef typename StoredValue<result_type>::type value_type;
+
+        // -------------------------------------------------------------------------------------- //
+
+        explicit Work(Func&& func):
+            m_func(std::forward<Func>(func))
+        {}
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief The future for the work's outcome.
+        Future<result_type> future(void){
+            return m_promise.future();
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        void run(void) override {
+            try {
+                m_value.reset(new value_type(_call(std::is_void<result_type>())));
+            }
+            catch (...) {
+                // Nothing may escape into libuv's threadpool, so foreign exceptions are wrapped.
+                m_error.reset(new error::Error(error::Error::current()));
+            }
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        void done(const int status) override {
+            if (status != 0) {
+                m_promise.reject(error::Error(status, error::uv_category<WorkError>()));
+            }
+            else if (m_value) {
+                resolve_promise(m_promise, std::move(*m_value));
+            }
+            else {
+                m_promise.reject(*m_error);
+            }
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    private:
+        value_type _call(std::false_type){
+            return m_func();
+        }
+
+        value_type _call(std::true_type){
+            m_func();
+            return value_type();
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        typename std::decay<Func>::type m_func; ///< The work to do.
+        Promise<result_type> m_promise;         ///< Settled once the work is done.
+        std::unique_ptr<value_type> m_value;    ///< The result, if the work succeeded.
+        std::unique_ptr<error::Error> m_error;  ///< The error, if the work threw.
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename Func>
+Future<_details::WorkResult<Func>> Loop::queue_work(Func&& func){
+    auto work = new _details::Work<Func>(std::forward<Func>(func));
+    auto future = work->future();
+    _queue_work(work);
+    return future;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename T>
+bool Loop::run_until(Future<T>& future){
+    auto& state = _details::FutureAccess::state(future);
+    while (!state.is_ready()) {
+        if (!run_once()) {
+            return state.is_ready();
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename T>
+template<typename Func>
+auto Future<T>::then(const Priority priority, Func&& func){
+    Loop& loop = *Loop::current();
+    return then([&loop, priority](T&& value){
+        Promise<T> lane;
+        auto future = lane.future();
+        loop.defer([lane = std::move(lane), value = std::move(value)]() mutable {
+            lane.resolve(std::move(value));
+        }, priority);
+        return future;
+    }).then(std::forward<Func>(func));
+}
+
+template<typename Func>
+auto Future<void>::then(const Priority priority, Func&& func){
+    Loop& loop = *Loop::current();
+    return then([&loop, priority](){
+        Promise<> lane;
+        auto future = lane.future();
+        loop.defer([lane = std::move(lane)]() mutable {
+            lane.resolve();
+        }, priority);
+        return future;
+    }).then(std::forward<Func>(func));
+}
+
+}
+}
@@ -0,0 +1,289 @@
+
+#include <algorithm>
+#include <cstdint>
+#include <uv.h>
+
+#ifdef __linux__
+#   include <cerrno>
+#   include <sys/timerfd.h>
+#   include <unistd.h>
+#endif
+
+#include "lw/event/HandlePool.hpp"
+#include "lw/event/PreciseTimeout.hpp"
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace {
+#ifdef __linux__
+    timespec _to_timespec(const PreciseTimeout::resolution duration){
+        timespec spec;
+        spec.tv_sec = (time_t)(duration.count() / 1000000000);
+        spec.tv_nsec = (long)(duration.count() % 1000000000);
+        return spec;
+    }
+#else
+    std::uint64_t _ceil_milliseconds(const PreciseTimeout::resolution duration){
+        return (std::uint64_t)((duration.count() + 999999) / 1000000);
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+struct PreciseTimeout::_State {
+    explicit _State(Loop& loop);
+    ~_State(void);
+
+#ifdef __linux__
+    int fd;                                 ///< The timerfd counting down.
+    uv_poll_s* poll;                        ///< Watches the timerfd for expirations.
+#else
+    uv_timer_s* timer;                      ///< The millisecond timer standing in for a timerfd.
+#endif
+    bool repeating;                         ///< Flag indicating the timer has an interval.
+    Promise<> promise;
+    UniqueFunction<void(bool)> task;
+    repeat_callback callback;
+    CancellationRegistration cancellation;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+#ifdef __linux__
+PreciseTimeout::_State::_State(Loop& loop):
+    fd(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+    poll(nullptr),
+    repeating(false)
+{
+    if (fd < 0) {
+        throw LW_UV_ERROR(TimeoutError, -errno);
+    }
+
+    poll = HandlePool::allocate<uv_poll_t>();
+    const int res = uv_poll_init(loop.lowest_layer(), poll, fd);
+    if (res < 0) {
+        HandlePool::deallocate(poll);
+        ::close(fd);
+        throw LW_UV_ERROR(TimeoutError, res);
+    }
+    poll->data = (void*)this;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PreciseTimeout::_State::~_State(void){
+    // Closing the handle stops polling the descriptor straight away, so it is safe to close now.
+    HandlePool::close((uv_handle_t*)poll);
+    ::close(fd);
+}
+#else
+PreciseTimeout::_State::_State(Loop& loop):
+    timer(HandlePool::allocate<uv_timer_t>()),
+    repeating(false)
+{
+    uv_timer_init(loop.lowest_layer(), timer);
+    timer->data = (void*)this;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PreciseTimeout::_State::~_State(void){
+    HandlePool::close((uv_handle_t*)timer);
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------- //
+
+PreciseTimeout::PreciseTimeout(Loop& loop):
+    m_state(std::make_shared<_State>(loop))
+{}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Future<> PreciseTimeout::start(const resolution delay){
+    _reset_promise();
+    auto state = m_state;
+    m_state->task = [state](bool cancel) mutable {
+        state->cancellation.reset();
+        if (cancel) {
+            state->promise.reject(TimeoutError(1, "Timeout cancelled."));
+        }
+        else {
+            state->promise.resolve();
+        }
+        state.reset();
+    };
+    _arm(delay, resolution(0));
+    return m_state->promise.future();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Future<> PreciseTimeout::start(const resolution delay, const CancellationToken& token){
+    auto future = start(delay);
+    std::weak_ptr<_State> weak_state = m_state;
+    m_state->cancellation = token.on_cancel([weak_state](){
+        if (auto state = weak_state.lock()) {
+            PreciseTimeout(state)._cancel();
+        }
+    });
+    return future;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Future<> PreciseTimeout::repeat(const resolution interval, repeat_callback cb){
+    _reset_promise();
+    auto state = m_state;
+    m_state->callback = std::move(cb);
+    m_state->task = [state](bool cancel) mutable {
+        if (cancel) {
+            state->callback = nullptr;
+            state->promise.resolve();
+            state.reset();
+        }
+        else {
+            PreciseTimeout timeout(state);
+            state->callback(timeout);
+        }
+    };
+    _arm(interval, interval);
+    return m_state->promise.future();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::stop(void){
+    _disarm();
+    if (m_state->task) {
+        m_state->task(true); // true == cancelled
+        m_state->task = nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::unref(void){
+#ifdef __linux__
+    uv_unref((uv_handle_t*)m_state->poll);
+#else
+    uv_unref((uv_handle_t*)m_state->timer);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::_fire(_State& state, const int status){
+    if (!state.task) {
+        return;
+    }
+    if (status < 0) {
+        // The task holds a reference to the state, drop it without running it.
+        auto task = std::move(state.task);
+        state.task = nullptr;
+        state.cancellation.reset();
+        state.promise.reject(LW_UV_ERROR(TimeoutError, status));
+        return;
+    }
+    if (!state.repeating) {
+        // A one-shot task is finished once it has run, so a later `stop` must not find it.
+        auto task = std::move(state.task);
+        state.task = nullptr;
+        task(false); // false == not cancelled
+        return;
+    }
+    state.task(false); // false == not cancelled
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::_arm(const resolution delay, const resolution interval){
+    m_state->repeating = interval.count() > 0;
+#ifdef __linux__
+    // A zero initial expiration disarms a timerfd, so the shortest delay is a nanosecond.
+    itimerspec spec;
+    spec.it_value = _to_timespec(std::max(delay, resolution(1)));
+    spec.it_interval = _to_timespec(std::max(interval, resolution(0)));
+    ::timerfd_settime(m_state->fd, 0, &spec, nullptr);
+
+    uv_poll_start(m_state->poll, UV_READABLE, [](uv_poll_t* handle, int status, int){
+        _State& state = *(_State*)handle->data;
+        if (status == 0) {
+            // Re-arming since the poll resets the count, which is not an expiration.
+            std::uint64_t expirations = 0;
+            if (::read(state.fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                return;
+            }
+        }
+        if (!state.repeating || status < 0) {
+            uv_poll_stop(handle);
+        }
+        _fire(state, status);
+    });
+#else
+    uv_timer_start(
+        m_state->timer,
+        [](uv_timer_t* handle){ _fire(*(_State*)handle->data, 0); },
+        _ceil_milliseconds(std::max(delay, resolution(0))),
+        _ceil_milliseconds(std::max(interval, resolution(0)))
+    );
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::_disarm(void){
+    m_state->repeating = false;
+#ifdef __linux__
+    itimerspec spec = {};
+    ::timerfd_settime(m_state->fd, 0, &spec, nullptr);
+    uv_poll_stop(m_state->poll);
+#else
+    uv_timer_stop(m_state->timer);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::_reset_promise(void){
+    // A finished promise holds on to its outcome, so restarting the timeout needs a fresh one.
+    if (m_state->promise.is_finished()) {
+        m_state->promise.reset();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PreciseTimeout::_cancel(void){
+    _disarm();
+    if (m_state->task) {
+        // The task holds a reference to the state, drop it without running it.
+        auto task = std::move(m_state->task);
+        m_state->task = nullptr;
+        m_state->promise.reject(CancelledError(1, "Timeout cancelled."));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Future<> wait_precisely(Loop& loop, const PreciseTimeout::resolution delay){
+    PreciseTimeout timeout(loop);
+    return timeout.start(delay);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Future<> wait_precisely(
+    Loop& loop,
+    const PreciseTimeout::resolution delay,
+    const CancellationToken& token
+){
+    PreciseTimeout timeout(loop);
+    return timeout.start(delay, token);
+}
+
+}
+}
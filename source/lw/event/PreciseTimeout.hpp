@@ -0,0 +1,189 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "lw/event/Cancellation.hpp"
+#include "lw/event/Loop.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+#include "lw/event/Timeout.hpp"
+#include "lw/event/UniqueFunction.hpp"
+
+namespace lw {
+namespace event {
+
+/// @brief A timeout with sub-millisecond resolution.
+///
+/// `Timeout` is driven by libuv's timers which only count whole milliseconds from the loop's cached
+/// time. On Linux a `PreciseTimeout` instead arms its own `timerfd` on `CLOCK_MONOTONIC`, which the
+/// loop polls like any other file descriptor, so it fires within tens of microseconds of the delay.
+/// Elsewhere it falls back to a libuv timer with the delay rounded up to the next millisecond.
+///
+/// Each precise timeout holds a file descriptor and a poll handle, so keep `Timeout` for the many
+/// timers which do not need the precision.
+///
+/// @par Example
+/// @code{.cpp}
+///     event::PreciseTimeout pacer(loop);
+///     pacer.repeat(std::chrono::microseconds(150), [&](event::PreciseTimeout& timeout){
+///         if (!send_next()) {
+///             timeout.stop();
+///         }
+///     });
+/// @endcode
+class PreciseTimeout {
+public:
+    /// @brief The maximum resolution supported for durations.
+    typedef std::chrono::nanoseconds resolution;
+
+    /// @brief Callback type used for repeating timeouts.
+    ///
+    /// @param timeout A reference to the repeating `PreciseTimeout`.
+    typedef UniqueFunction<void(PreciseTimeout& timeout)> repeat_callback;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Sets up the timer on the loop.
+    ///
+    /// @throws TimeoutError If the timer could not be created.
+    ///
+    /// @param loop The event loop to schedule the timeout on.
+    explicit PreciseTimeout(Loop& loop);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Schedules the event to happen in the future.
+    ///
+    /// Unlike `Timeout`, the delay is counted from now rather than the loop's cached time.
+    ///
+    /// @param delay How long to wait before resolving.
+    ///
+    /// @return A future that will be resolved after the time has passed.
+    Future<> start(const resolution delay);
+
+    /// @brief Schedules the event to happen in the future unless cancelled.
+    ///
+    /// Cancelling the token stops the timer and rejects the future with a `CancelledError`.
+    ///
+    /// @param delay How long to wait before resolving.
+    /// @param token The token to stop the timer with.
+    ///
+    /// @return A future that will be resolved after the time has passed.
+    Future<> start(const resolution delay, const CancellationToken& token);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Schedules a callback to be called repeatedly.
+    ///
+    /// The repetitions keep to the interval's schedule. If the loop falls behind by more than an
+    /// interval, the missed calls are merged into one.
+    ///
+    /// @param interval How long between calls.
+    /// @param cb       The callback to execute repeatedly.
+    ///
+    /// @return A future that will be resolved when the repeating is stopped.
+    Future<> repeat(const resolution interval, repeat_callback cb);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Stops the timeout from executing.
+    ///
+    /// As with `Timeout::stop`, a pending `start` is rejected and a `repeat` is resolved.
+    void stop(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Lets the loop exit while this timeout is pending.
+    ///
+    /// A pending timeout holds on to its timer until it fires, so `stop` it once it is not needed.
+    void unref(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    struct _State; ///< Type used for managing internal state.
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Constructs a timeout around existing state.
+    ///
+    /// @param state The existing timeout state to wrap.
+    explicit PreciseTimeout(const std::shared_ptr<_State>& state):
+        m_state(state)
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Triggers the state's callback, or rejects it if the timer failed.
+    ///
+    /// @param state  The state of the timer that fired.
+    /// @param status Zero, or the libuv error the timer failed with.
+    static void _fire(_State& state, const int status);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Starts the timer.
+    ///
+    /// @param delay    The time until the first trigger.
+    /// @param interval The time between triggers after that, or zero for once.
+    void _arm(const resolution delay, const resolution interval);
+
+    /// @brief Stops the timer.
+    void _disarm(void);
+
+    /// @brief Makes the promise ready for another run if it has already finished.
+    void _reset_promise(void);
+
+    /// @brief Stops the timer and rejects the promise with a `CancelledError`.
+    void _cancel(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    std::shared_ptr<_State> m_state; ///< The timeout state information.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Starts a precise timeout that will be resolved at some point in the future.
+///
+/// @param loop  The event loop to use for waiting.
+/// @param delay The amount of time to wait.
+///
+/// @return A future that will be resolved after time has passed.
+Future<> wait_precisely(Loop& loop, const PreciseTimeout::resolution delay);
+
+/// @brief Starts a precise timeout that can be cancelled before it resolves.
+///
+/// @param loop  The event loop to use for waiting.
+/// @param delay The amount of time to wait.
+/// @param token The token to stop the timer with.
+///
+/// @return A future that will be resolved after time has passed.
+Future<> wait_precisely(
+    Loop& loop,
+    const PreciseTimeout::resolution delay,
+    const CancellationToken& token
+);
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Waits precisely until the provided point in time before resolving.
+///
+/// @param loop The event loop to use for waiting.
+/// @param when The point in time to wait until.
+///
+/// @return A future that will be resolved after the given point in time.
+template<class Clock, class Duration>
+Future<> wait_until_precisely(
+    Loop& loop,
+    const std::chrono::time_point<Clock, Duration>& when
+){
+    return wait_precisely(
+        loop,
+        std::chrono::duration_cast<PreciseTimeout::resolution>(when - Clock::now())
+    );
+}
+
+}
+}
@@ -1,11 +1,10 @@
 #pragma once
 
-#include <atomic>
-#include <functional>
-#include <memory>
 #include <type_traits>
 
 #include "lw/error.hpp"
+#include "lw/event/Loop.hpp"
+#include "lw/event/Promise.state.hpp"
 
 namespace lw {
 namespace event {
@@ -17,6 +16,15 @@ LW_DEFINE_EXCEPTION(PromiseError);
 template<typename T>
 class Future;
 
+template<typename T>
+class SharedFuture;
+
+class Executor;
+
+namespace _details {
+    struct FutureAccess;
+}
+
 // ---------------------------------------------------------------------------------------------- //
 
 /// @brief Determines if the given variable is a `Future`, or derives publicly from `Future`.
@@ -70,11 +78,22 @@ public:
     /// @brief Default construction.
     Promise(void):
         m_state(new _SharedState())
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Constructs a promise whose continuations always run on the given loop.
+    ///
+    /// The promise may then be resolved or rejected from any thread, which hands the outcome to
+    /// the loop through a lock-free queue. The loop is kept running until the promise is finished
+    /// or destroyed. This must be called from the thread running `loop`, and the future must only
+    /// be used from that thread.
+    ///
+    /// @param loop The loop which owns this promise.
+    explicit Promise(Loop& loop):
+        Promise()
     {
-        m_state->resolved   = false;
-        m_state->rejected   = false;
-        m_state->resolve    = nullptr;
-        m_state->reject     = nullptr;
+        m_state->bind(loop);
     }
 
     // ------------------------------------------------------------------------------------------ //
@@ -85,11 +104,9 @@ public:
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief Moves the promise from `other` to `this`.
-    Promise(Promise&& other):
+    Promise(Promise&& other) noexcept:
         m_state(std::move(other.m_state))
-    {
-        other.m_state = nullptr;
-    }
+    {}
 
     // ------------------------------------------------------------------------------------------ //
 
@@ -99,11 +116,10 @@ public:
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief Resolves the promise as a success.
+    ///
+    /// If nothing has been chained onto the future yet, the value is held until something is.
     void resolve(T&& value){
-        m_state->resolved = true;
-        if (m_state->resolve) {
-            m_state->resolve( std::move( value ) );
-        }
+        m_state->resolve(std::move(value));
     }
 
     // ------------------------------------------------------------------------------------------ //
@@ -116,13 +132,21 @@ public:
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief Rejects the promise as a failure.
-    void reject(const error::Exception& err){
-        m_state->rejected = true;
-        if (m_state->reject) {
-            m_state->reject(err);
-        }
-        else {
-            throw err;
+    ///
+    /// If nothing has been chained onto the future yet, the error is held until something is.
+    /// Exceptions convert to `error::Error` implicitly, and rejecting with an error value made
+    /// from a code and category never allocates.
+    ///
+    /// A rejection nobody can observe is raised here rather than lost. That includes one passed
+    /// along by a chained continuation to a future which was then dropped. Code rejecting on
+    /// behalf of consumers which may have dropped their futures, such as a fan-out or a teardown,
+    /// must catch it so one such consumer does not stop the rest from being settled.
+    ///
+    /// @throws error::Exception The error, via `error::Error::raise`, if the future was taken and
+    ///                          dropped without a handler chained.
+    void reject(const error::Error& err){
+        if (!m_state->reject(err)) {
+            err.raise();
         }
     }
 
@@ -135,10 +159,7 @@ public:
         if (!is_finished()) {
             throw PromiseError(1, "Cannot reset an unfinished promise.");
         }
-        m_state->resolved   = false;
-        m_state->rejected   = false;
-        m_state->resolve    = nullptr;
-        m_state->reject     = nullptr;
+        m_state->reset();
     }
 
     // ------------------------------------------------------------------------------------------ //
@@ -170,9 +191,8 @@ public:
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief Moves the promise from `other` into `this`.
-    Promise& operator=(Promise&& other){
+    Promise& operator=(Promise&& other) noexcept {
         m_state = std::move(other.m_state);
-        other.m_state = nullptr;
         return *this;
     }
 
@@ -183,13 +203,8 @@ private:
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief The container for the shared state between promises and futures.
-    struct _SharedState {
-        std::atomic_bool resolved;
-        std::atomic_bool rejected;
-        std::function<void(T&&)> resolve;
-        std::function<void(const error::Exception&)> reject;
-    };
-    typedef std::shared_ptr<_SharedState> _SharedStatePtr;
+    typedef _details::SharedState<T> _SharedState;
+    typedef _details::IntrusivePtr<_SharedState> _SharedStatePtr;
 
     // ------------------------------------------------------------------------------------------ //
 
@@ -249,10 +264,57 @@ public:
 
     // ------------------------------------------------------------------------------------------ //
 
+    /// @brief Converts this future into one which may have many continuations.
+    ///
+    /// The resolved value is kept by the `SharedFuture` and given to each continuation by
+    /// `const T&`. This future must not be used afterwards.
+    SharedFuture<T> share(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Chains a functor onto this future which runs on an `Executor`.
+    ///
+    /// The functor is given the resolved value on one of the executor's threads, and its result is
+    /// delivered back on the loop which was running when this future resolved. Rejections skip
+    /// the functor. The functor must return a plain value, not a future.
+    ///
+    /// @param executor The executor to run the functor on.
+    /// @param func     A functor taking `T&&`.
+    ///
+    /// @return A future for the result of `func`.
+    template<typename Func>
+    auto then_on(Executor& executor, Func&& func);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Chains a functor onto this future which runs in one of the loop's priority lanes.
+    ///
+    /// Once this future resolves, the functor is deferred in the given lane of the loop running on
+    /// the calling thread, so it waits behind any higher priority work. Rejections skip the lane
+    /// and pass straight on. Otherwise this behaves just like `then`.
+    ///
+    /// @par Example
+    /// @code{.cpp}
+    ///     read_request(client).then(Priority::HIGH, [](Request&& request){
+    ///         return handle_interactive(request);
+    ///     });
+    /// @endcode
+    ///
+    /// @param priority The lane to run the functor in.
+    /// @param func     A functor taking `T&&`.
+    ///
+    /// @return A future for the result of `func`.
+    template<typename Func>
+    auto then(const Priority priority, Func&& func);
+
+    // ------------------------------------------------------------------------------------------ //
+
 private:
     template<typename Type>
     friend class ::lw::event::Promise;
 
+    friend struct ::lw::event::_details::FutureAccess;
+
     // ------------------------------------------------------------------------------------------ //
 
     /// @brief Only `Promise`s can construct us.
@@ -1,19 +1,154 @@
 #pragma once
 
 #include "lw/event/Promise.hpp"
+#include "lw/trait.hpp"
 #include "lw/event/Promise.void.hpp"
 
 namespace lw {
 namespace event {
 
+namespace _details {
+    /// @internal
+    /// @brief Calls a `Promise`-taking resolve handler, omitting the value for `void` promises.
+    template< typename Resolve, typename Value, typename Next >
+    inline void call_resolve( Resolve& resolve, Value&& value, Next&& next ){
+        resolve( std::forward< Value >( value ), std::forward< Next >( next ) );
+    }
+
+    template< typename Resolve, typename Next >
+    inline void call_resolve( Resolve& resolve, Nothing&&, Next&& next ){
+        resolve( std::forward< Next >( next ) );
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Resolves a promise, omitting the value for `void` promises.
+    template< typename T, typename Value >
+    inline void resolve_promise( Promise< T >& promise, Value&& value ){
+        promise.resolve( std::forward< Value >( value ) );
+    }
+
+    inline void resolve_promise( Promise< void >& promise, Nothing&& ){
+        promise.resolve();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Calls a reject handler with the error value if it takes one, otherwise with the
+    /// error's exception.
+    template< typename Reject >
+    inline void call_reject( Reject& reject, const error::Error& err, std::true_type ){
+        reject( err );
+    }
+
+    template< typename Reject >
+    inline void call_reject( Reject& reject, const error::Error& err, std::false_type ){
+        reject( err.exception() );
+    }
+
+    template< typename Reject >
+    inline void call_reject( Reject& reject, const error::Error& err ){
+        call_reject(
+            reject,
+            err,
+            trait::is_callable< Reject&( const error::Error& ) >()
+        );
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The continuation stored by `Future::_then` for a single link in a promise chain.
+    ///
+    /// The handlers and the promise for the next link live together in one functor, which is
+    /// placed directly in the shared state of the previous link.
+    template< typename T, typename Result, typename Resolve, typename Reject >
+    struct ThenContinuation {
+        typedef typename StoredValue< T >::type value_type;
+
+        template< typename ResolveArg, typename RejectArg >
+        ThenContinuation(
+            ResolveArg&& resolve_arg,
+            RejectArg&& reject_arg,
+            Promise< Result >&& next_arg
+        ):
+            resolve( std::forward< ResolveArg >( resolve_arg ) ),
+            reject( std::forward< RejectArg >( reject_arg ) ),
+            next( std::move( next_arg ) )
+        {}
+
+        void operator()( value_type* value, const error::Error* err ){
+            if( value ){
+                call_resolve( resolve, std::move( *value ), std::move( next ) );
+            }
+            else {
+                _reject( *err, std::is_same< std::nullptr_t, Reject >() );
+            }
+        }
+
+        void _reject( const error::Error& err, std::true_type ){
+            next.reject( err );
+        }
+
+        void _reject( const error::Error& err, std::false_type ){
+            call_reject( reject, err );
+        }
+
+        Resolve resolve;
+        Reject reject;
+        Promise< Result > next;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Gives library internals access to the shared state behind a `Future`.
+    struct FutureAccess {
+        template< typename T >
+        static SharedState< T >& state( Future< T >& future ){
+            return *future.m_state;
+        }
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The continuation stored by `Future::then( Promise&& )` to forward the outcome.
+    template< typename T >
+    struct ForwardContinuation {
+        typedef typename StoredValue< T >::type value_type;
+
+        ForwardContinuation( Promise< T >&& next_arg ):
+            next( std::move( next_arg ) )
+        {}
+
+        void operator()( value_type* value, const error::Error* err ){
+            if( value ){
+                resolve_promise( next, std::move( *value ) );
+            }
+            else {
+                next.reject( *err );
+            }
+        }
+
+        Promise< T > next;
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
 template< typename T >
 inline Future< T > Promise< T >::future( void ){
+    m_state->future_taken = true;
     return Future< T >( m_state );
 }
 
 // ---------------------------------------------------------------------------------------------- //
 
 inline Future< void > Promise< void >::future( void ){
+    m_state->future_taken = true;
     return Future< void >( m_state );
 }
 
@@ -22,33 +157,21 @@ inline Future< void > Promise< void >::future( void ){
 template< typename T >
 template< typename Result, typename Resolve, typename Reject, typename >
 Future< Result > Future< T >::_then( Resolve&& resolve, Reject&& reject ){
-    auto next = std::make_shared< Promise< Result > >();
-    auto prev = m_state;
-    m_state->resolve = [ resolve, prev, next ]( T&& value ) mutable {
-        resolve( std::move( value ), std::move( *next ) );
-        prev->reject = nullptr;
-        prev.reset();
-    };
-
-    typedef std::function< void( const error::Exception& ) > RejectHandler;
-    RejectHandler rejectHandler;
-    if( std::is_same< std::nullptr_t, Reject >::value ){
-        rejectHandler = [ next ]( const error::Exception& err ){
-            next->reject( err );
-        };
-    }
-    else {
-        rejectHandler = std::forward< Reject >( reject );
-    }
-    m_state->reject = [ rejectHandler, prev, next ](
-        const error::Exception& err
-    ) mutable {
-        rejectHandler( err );
-        prev->resolve = nullptr;
-        prev.reset();
-    };
-
-    return next->future();
+    typedef _details::ThenContinuation<
+        T,
+        Result,
+        typename std::decay< Resolve >::type,
+        typename std::decay< Reject >::type
+    > Continuation;
+
+    Promise< Result > next;
+    Future< Result > future = next.future();
+    m_state->template then< Continuation >(
+        std::forward< Resolve   >( resolve  ),
+        std::forward< Reject    >( reject   ),
+        std::move( next )
+    );
+    return future;
 }
 
 // ---------------------------------------------------------------------------------------------- //
@@ -74,7 +197,9 @@ template<
 Future< typename ResolveResult::result_type > Future< T >::_then( Resolve&& resolve, Reject&& reject ){
     typedef typename ResolveResult::result_type Result;
     return then< Result >(
-        [ resolve ]( T&& value, Promise< Result >&& promise ) mutable {
+        [ resolve = std::forward< Resolve >( resolve ) ](
+            T&& value, Promise< Result >&& promise
+        ) mutable {
             resolve( std::move( value ) ).then( std::move( promise ) );
         },
         std::forward< Reject >( reject )
@@ -95,12 +220,14 @@ template<
 >
 Future< ResolveResult > Future< T >::_then( Resolve&& resolve, Reject&& reject ){
     return then< ResolveResult >(
-        [ resolve ]( T&& value, Promise< ResolveResult >&& promise ) mutable {
+        [ resolve = std::forward< Resolve >( resolve ) ](
+            T&& value, Promise< ResolveResult >&& promise
+        ) mutable {
             try {
                 promise.resolve( resolve( std::move( value ) ) );
             }
-            catch( const error::Exception& err ){
-                promise.reject( err );
+            catch( const error::Exception& ){
+                promise.reject( error::Error::current() );
             }
         },
         std::forward< Reject >( reject )
@@ -118,12 +245,14 @@ template<
 >
 Future<> Future< T >::_then( Resolve&& resolve, Reject&& reject ){
     return then(
-        [ resolve ]( T&& value, Promise<>&& promise ){
+        [ resolve = std::forward< Resolve >( resolve ) ](
+            T&& value, Promise<>&& promise
+        ) mutable {
             try {
                 resolve( std::move( value ) );
             }
-            catch( const error::Exception& err ){
-                promise.reject( err );
+            catch( const error::Exception& ){
+                promise.reject( error::Error::current() );
                 return;
             }
             promise.resolve();
@@ -136,51 +265,30 @@ Future<> Future< T >::_then( Resolve&& resolve, Reject&& reject ){
 
 template< typename T >
 void Future< T >::then( promise_type&& promise ){
-    auto next = std::make_shared< promise_type >( std::move( promise ) );
-    auto prev = m_state;
-    m_state->resolve = [ prev, next ]( T&& value ) mutable {
-        next->resolve( std::move( value ) );
-        prev->reject = nullptr;
-        prev.reset();
-    };
-    m_state->reject = [ prev, next ]( const error::Exception& err ) mutable {
-        next->reject( err );
-        prev->resolve = nullptr;
-        prev.reset();
-    };
+    m_state->template then< _details::ForwardContinuation< T > >(
+        std::move( promise )
+    );
 }
 
 // ---------------------------------------------------------------------------------------------- //
 
 template< typename Result, typename Resolve, typename Reject, typename >
 Future< Result > Future< void >::_then( Resolve&& resolve, Reject&& reject ){
-    auto next = std::make_shared< Promise< Result > >();
-    auto prev = m_state;
-    m_state->resolve = [ resolve, prev, next ]() mutable {
-        resolve( std::move( *next ) );
-        prev->reject = nullptr;
-        prev.reset();
-    };
-
-    typedef std::function< void( const error::Exception& ) > RejectHandler;
-    RejectHandler rejectHandler;
-    if( std::is_same< std::nullptr_t, Reject >::value ){
-        rejectHandler = [ next ]( const error::Exception& err ){
-            next->reject( err );
-        };
-    }
-    else {
-        rejectHandler = std::forward< Reject >( reject );
-    }
-    m_state->reject = [ rejectHandler, prev, next ](
-        const error::Exception& err
-    ) mutable {
-        rejectHandler( err );
-        prev->resolve = nullptr;
-        prev.reset();
-    };
-
-    return next->future();
+    typedef _details::ThenContinuation<
+        void,
+        Result,
+        typename std::decay< Resolve >::type,
+        typename std::decay< Reject >::type
+    > Continuation;
+
+    Promise< Result > next;
+    Future< Result > future = next.future();
+    m_state->template then< Continuation >(
+        std::forward< Resolve   >( resolve  ),
+        std::forward< Reject    >( reject   ),
+        std::move( next )
+    );
+    return future;
 }
 
 // ---------------------------------------------------------------------------------------------- //
@@ -204,7 +312,7 @@ template<
 Future< typename ResolveResult::result_type > Future< void >::_then( Resolve&& resolve, Reject&& reject ){
     typedef typename ResolveResult::result_type Result;
     return then< Result >(
-        [ resolve ]( Promise< Result >&& promise ){
+        [ resolve = std::forward< Resolve >( resolve ) ]( Promise< Result >&& promise ) mutable {
             resolve().then( std::move( promise ) );
         },
         std::forward< Reject >( reject )
@@ -224,12 +332,14 @@ template<
 >
 Future< ResolveResult > Future< void >::_then( Resolve&& resolve, Reject&& reject ){
     return then< ResolveResult >(
-        [ resolve ]( Promise< ResolveResult >&& promise ){
+        [ resolve = std::forward< Resolve >( resolve ) ](
+            Promise< ResolveResult >&& promise
+        ) mutable {
             try {
                 promise.resolve( resolve() );
             }
-            catch( const error::Exception& err ){
-                promise.reject( err );
+            catch( const error::Exception& ){
+                promise.reject( error::Error::current() );
             }
         },
         std::forward< Reject >( reject )
@@ -246,12 +356,12 @@ template<
 >
 Future< void > Future< void >::_then( Resolve&& resolve, Reject&& reject ){
     return then< void >(
-        [ resolve ]( Promise< void >&& promise ){
+        [ resolve = std::forward< Resolve >( resolve ) ]( Promise< void >&& promise ) mutable {
             try {
                 resolve();
             }
-            catch( const error::Exception& err ){
-                promise.reject( err );
+            catch( const error::Exception& ){
+                promise.reject( error::Error::current() );
                 return;
             }
             promise.resolve();
@@ -263,18 +373,9 @@ Future< void > Future< void >::_then( Resolve&& resolve, Reject&& reject ){
 // ---------------------------------------------------------------------------------------------- //
 
 inline void Future< void >::then( promise_type&& promise ){
-    auto next = std::make_shared< promise_type >( std::move( promise ) );
-    auto prev = m_state;
-    m_state->resolve = [ prev, next ]() mutable {
-        next->resolve();
-        prev->reject = nullptr;
-        prev.reset();
-    };
-    m_state->reject = [ prev, next ]( const error::Exception& err ) mutable {
-        next->reject( err );
-        prev->resolve = nullptr;
-        prev.reset();
-    };
+    m_state->template then< _details::ForwardContinuation< void > >(
+        std::move( promise )
+    );
 }
 
 }
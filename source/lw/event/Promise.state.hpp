@@ -0,0 +1,580 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lw/error.hpp"
+#include "lw/event/UniqueFunction.hpp"
+#include "lw/event/Loop.hpp"
+#include "lw/event/Stats.hpp"
+#include "lw/memory/FreeList.hpp"
+
+namespace lw {
+namespace event {
+namespace _details {
+
+/// @brief Placeholder value passed through the shared state of `void` promises.
+struct Nothing {};
+
+/// @brief Maps a promised type to the type actually carried by the shared state.
+template<typename T>
+struct StoredValue {
+    typedef T type;
+};
+
+template<>
+struct StoredValue<void> {
+    typedef Nothing type;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Promise states and joins are pooled in the thread-local free lists.
+using ::lw::memory::FreeList;
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief A smart pointer for objects which manage their own reference count.
+///
+/// @tparam T A type providing `add_ref()` and `release()`.
+template<typename T>
+class IntrusivePtr {
+public:
+    IntrusivePtr(void):
+        m_ptr(nullptr)
+    {}
+
+    IntrusivePtr(std::nullptr_t):
+        m_ptr(nullptr)
+    {}
+
+    /// @brief Takes a new reference to `ptr`.
+    explicit IntrusivePtr(T* ptr):
+        m_ptr(ptr)
+    {
+        if (m_ptr) {
+            m_ptr->add_ref();
+        }
+    }
+
+    IntrusivePtr(const IntrusivePtr& other):
+        IntrusivePtr(other.m_ptr)
+    {}
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept:
+        m_ptr(other.m_ptr)
+    {
+        other.m_ptr = nullptr;
+    }
+
+    ~IntrusivePtr(void){
+        if (m_ptr) {
+            m_ptr->release();
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    T* get(void) const {
+        return m_ptr;
+    }
+
+    T* operator->(void) const {
+        return m_ptr;
+    }
+
+    T& operator*(void) const {
+        return *m_ptr;
+    }
+
+    explicit operator bool(void) const {
+        return m_ptr != nullptr;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    IntrusivePtr& operator=(const IntrusivePtr& other){
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(std::nullptr_t){
+        IntrusivePtr().swap(*this);
+        return *this;
+    }
+
+    void swap(IntrusivePtr& other) noexcept {
+        T* ptr = m_ptr;
+        m_ptr = other.m_ptr;
+        other.m_ptr = ptr;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    T* m_ptr;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Base for objects which are shared through an `IntrusivePtr`.
+///
+/// The object deletes itself when the last reference is released.
+///
+/// @tparam Derived The type deriving from `RefCounted`.
+template<typename Derived>
+class RefCounted {
+public:
+    RefCounted(void):
+        m_refs(0)
+    {}
+
+    RefCounted(const RefCounted&) = delete;
+    RefCounted& operator=(const RefCounted&) = delete;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    void add_ref(void){
+        m_refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(void){
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete static_cast<Derived*>(this);
+        }
+    }
+
+    /// @brief The number of references currently held.
+    std::size_t ref_count(void) const {
+        return m_refs.load(std::memory_order_acquire);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    std::atomic<std::size_t> m_refs;    ///< The number of references to this object.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Runs continuations without letting the native stack grow with the length of a chain.
+///
+/// Finishing a promise calls its continuation, which usually finishes the next promise in the
+/// chain, and so on. Loops built from promises, such as reading a file chunk by chunk inside its
+/// own continuation, would recurse forever when the results are already available. Once the
+/// continuations on a thread are nested `max_depth` deep, new ones are queued instead and run one
+/// after another by the outermost continuation once it returns.
+class Trampoline {
+public:
+    /// @brief The deepest continuations may nest before being queued.
+    static constexpr std::size_t max_depth = 64;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if continuations must be queued rather than called.
+    static bool is_too_deep(void){
+        return _frames().depth >= max_depth;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls the functor as a continuation.
+    ///
+    /// If this is the outermost continuation on the thread then any queued by the functor are run
+    /// before returning.
+    ///
+    /// @param func The functor to call.
+    template<typename Func>
+    static void call(Func&& func){
+        _Frames& frames = _frames();
+        _Depth depth(frames);
+#ifdef LW_ENABLE_EVENT_STATS
+        ++frames.chain;
+#endif
+        func();
+        if (frames.depth == 1) {
+            if (frames.next < frames.queue.size()) {
+                _drain(frames);
+            }
+#ifdef LW_ENABLE_EVENT_STATS
+            if (auto& counters = StatsCounters::current()) {
+                counters->record_chain(frames.chain);
+            }
+            frames.chain = 0;
+#endif
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Queues a functor to be run by the outermost continuation.
+    ///
+    /// @param func The functor to queue.
+    template<typename Func>
+    static void defer(Func&& func){
+        _frames().queue.emplace_back(std::forward<Func>(func));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    struct _Frames {
+        std::size_t depth;                          ///< Number of nested continuations.
+        std::size_t next;                           ///< Index of the next queued functor to run.
+        std::vector<UniqueFunction<void(void)>> queue;  ///< Continuations waiting to run.
+#ifdef LW_ENABLE_EVENT_STATS
+        std::size_t chain;                          ///< Continuations run by the outermost one.
+#endif
+    };
+
+    /// @brief Counts a continuation for as long as it is running.
+    struct _Depth {
+        _Depth(_Frames& frames): frames(frames) { ++frames.depth; }
+        ~_Depth(void){ --frames.depth; }
+        _Frames& frames;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    static _Frames& _frames(void){
+        static thread_local _Frames frames = {};
+        return frames;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Runs queued functors in order, including any queued while draining.
+    static void _drain(_Frames& frames){
+        while (frames.next < frames.queue.size()) {
+            UniqueFunction<void(void)> func(std::move(frames.queue[frames.next++]));
+#ifdef LW_ENABLE_EVENT_STATS
+            ++frames.chain;
+#endif
+            func();
+        }
+        frames.queue.clear();
+        frames.next = 0;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief The state shared between a `Promise` and its `Future`s.
+///
+/// The state is allocated from a thread-local `FreeList` and is reference counted intrusively, so
+/// creating one costs no heap allocation once the pool is warm. The continuation registered by
+/// `Future::then` is stored inline as a single functor which handles both resolution and rejection.
+///
+/// If the promise is finished before a continuation is registered, the value or error is held by
+/// the state and handed to the continuation as soon as it is registered.
+///
+/// Continuations are run through the `Trampoline`, so a long chain finishing all at once is run
+/// iteratively rather than recursively.
+///
+/// When built with `LW_ENABLE_EVENT_STATS` each state is counted in the current loop's `LoopStats`.
+///
+/// A state may be bound to the `Loop` which owns it. Bound states can be resolved or rejected from
+/// any thread, the outcome is sent to the loop and only ever touches the continuation there.
+///
+/// @tparam T The promised type.
+template<typename T>
+class SharedState : public RefCounted<SharedState<T>>, private StateStats {
+public:
+    /// @brief The type of value passed to the continuation.
+    typedef typename StoredValue<T>::type value_type;
+
+    /// @brief The continuation functor type.
+    ///
+    /// Exactly one of the two arguments will be non-null: the value on resolution or the error on
+    /// rejection. The continuation may move from the value.
+    typedef UniqueFunction<void(value_type*, const error::Error*), 56> continuation_type;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    static void* operator new(std::size_t){
+        return FreeList<SharedState>::allocate();
+    }
+
+    static void operator delete(void* ptr){
+        FreeList<SharedState>::deallocate(ptr);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    SharedState(void):
+        resolved(false),
+        rejected(false),
+        future_taken(false),
+        m_held(_NOTHING_HELD),
+        m_loop(nullptr),
+        m_holds_loop(false)
+    {}
+
+    ~SharedState(void){
+        _clear_held();
+        _release_loop();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Binds this state to the loop which will run its continuation.
+    ///
+    /// The loop is kept running until the state is finished or destroyed. This must be called
+    /// from the loop's thread.
+    ///
+    /// @param loop The loop to bind to.
+    void bind(Loop& loop){
+        m_loop = &loop;
+        _hold_loop();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Marks the state resolved and passes the value to the continuation.
+    ///
+    /// If no continuation has been registered yet, the value is held until one is. When called
+    /// off of the bound loop's thread the value is sent to the loop instead.
+    void resolve(value_type&& value){
+        this->_stats_finished();
+        if (m_loop && !m_loop->is_loop_thread()) {
+            resolved = true;
+            m_loop->post(
+                [state = IntrusivePtr<SharedState>(this), value = std::move(value)]() mutable {
+                    state->_resolve(std::move(value));
+                }
+            );
+            return;
+        }
+        _resolve(std::move(value));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Marks the state rejected and passes the error to the continuation.
+    ///
+    /// If no continuation has been registered yet, the error is held until one is. However, if the
+    /// future has been taken and every reference to it has since been dropped then nothing can
+    /// ever receive the error. Rejections sent from another thread to the bound loop cannot be
+    /// checked and are dropped if unobservable.
+    ///
+    /// @return False if the error can never be handled.
+    bool reject(const error::Error& err){
+        this->_stats_finished();
+        if (m_loop && !m_loop->is_loop_thread()) {
+            rejected = true;
+            m_loop->post([state = IntrusivePtr<SharedState>(this), err](){
+                state->_reject(err);
+            });
+            return true;
+        }
+        return _reject(err);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Registers the continuation, calling it immediately if the promise is finished.
+    ///
+    /// @tparam Func The continuation functor type to construct.
+    ///
+    /// @param args The arguments to construct the continuation with.
+    template<typename Func, typename... Args>
+    void then(Args&&... args){
+        if (m_held == _NOTHING_HELD) {
+            m_continuation.template emplace<Func>(std::forward<Args>(args)...);
+            return;
+        }
+
+        // Already finished, skip storing the continuation and run it straight away. The held
+        // outcome is released once the continuation is done with it.
+        if (Trampoline::is_too_deep()) {
+            m_continuation.template emplace<Func>(std::forward<Args>(args)...);
+            _defer_held();
+            return;
+        }
+        Func next(std::forward<Args>(args)...);
+        Trampoline::call([&](){
+            this->_stats_continued();
+            _HeldGuard guard(*this);
+            if (m_held == _VALUE_HELD) {
+                next(_value(), nullptr);
+            }
+            else {
+                next(nullptr, _error());
+            }
+        });
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if the outcome is held and a continuation given now would be called
+    /// immediately.
+    bool is_ready(void) const {
+        return m_held != _NOTHING_HELD && !Trampoline::is_too_deep();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Returns the state to pending so it can be used again.
+    void reset(void){
+        resolved = false;
+        rejected = false;
+        future_taken = false;
+        m_continuation = nullptr;
+        _clear_held();
+        _hold_loop();
+        this->_stats_reset();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    std::atomic_bool resolved;  ///< Flag indicating the promise has been resolved.
+    std::atomic_bool rejected;  ///< Flag indicating the promise has been rejected.
+    bool future_taken;          ///< Flag indicating a future has been made for this state.
+
+private:
+    /// @brief What, if anything, is held in the outcome storage.
+    enum _Held : unsigned char {
+        _NOTHING_HELD,
+        _VALUE_HELD,
+        _ERROR_HELD
+    };
+
+    /// @brief Storage for either the value or the error, constructed and destroyed manually.
+    union _Outcome {
+        _Outcome(void){}
+        ~_Outcome(void){}
+
+        value_type value;
+        error::Error error;
+    };
+
+    /// @brief Clears the held outcome when it goes out of scope.
+    struct _HeldGuard {
+        _HeldGuard(SharedState& state): state(state) {}
+        ~_HeldGuard(void){ state._clear_held(); }
+        SharedState& state;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    value_type* _value(void){
+        return &m_outcome.value;
+    }
+
+    const error::Error* _error(void){
+        return &m_outcome.error;
+    }
+
+    /// @brief Destroys the held value or error, if there is one.
+    void _clear_held(void){
+        if (m_held == _VALUE_HELD) {
+            _value()->~value_type();
+        }
+        else if (m_held == _ERROR_HELD) {
+            m_outcome.error.~Error();
+        }
+        m_held = _NOTHING_HELD;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Resolves the state on the current thread.
+    void _resolve(value_type&& value){
+        resolved = true;
+        _release_loop();
+        if (m_continuation && !Trampoline::is_too_deep()) {
+            // The continuation is moved off of the state before being called so it may safely
+            // reset or release this state while running.
+            continuation_type next(std::move(m_continuation));
+            Trampoline::call([&](){
+                this->_stats_continued();
+                next(&value, nullptr);
+            });
+            return;
+        }
+        new (_value()) value_type(std::move(value));
+        m_held = _VALUE_HELD;
+        if (m_continuation) {
+            _defer_held();
+        }
+    }
+
+    /// @brief Rejects the state on the current thread.
+    bool _reject(const error::Error& err){
+        rejected = true;
+        _release_loop();
+        if (m_continuation && !Trampoline::is_too_deep()) {
+            continuation_type next(std::move(m_continuation));
+            Trampoline::call([&](){
+                this->_stats_continued();
+                next(nullptr, &err);
+            });
+            return true;
+        }
+        if (!m_continuation && future_taken && this->ref_count() <= 1) {
+            return false;
+        }
+        new (&m_outcome.error) error::Error(err);
+        m_held = _ERROR_HELD;
+        if (m_continuation) {
+            _defer_held();
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Queues the continuation to be called with the held outcome by the `Trampoline`.
+    void _defer_held(void){
+        Trampoline::defer([state = IntrusivePtr<SharedState>(this)](){
+            continuation_type next(std::move(state->m_continuation));
+            state->_stats_continued();
+            _HeldGuard guard(*state);
+            if (state->m_held == _VALUE_HELD) {
+                next(state->_value(), nullptr);
+            }
+            else {
+                next(nullptr, state->_error());
+            }
+        });
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Keeps the bound loop alive while this state is pending.
+    void _hold_loop(void){
+        if (m_loop && !m_holds_loop) {
+            m_holds_loop = true;
+            m_loop->_add_keep_alive();
+        }
+    }
+
+    /// @brief Lets the bound loop exit once nothing else is keeping it alive.
+    void _release_loop(void){
+        if (m_holds_loop) {
+            m_holds_loop = false;
+            m_loop->_release_keep_alive();
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    continuation_type m_continuation;   ///< The functor to call when the promise is finished.
+    _Outcome m_outcome;                 ///< Storage for a value or error awaiting a continuation.
+    _Held m_held;                       ///< What is held in `m_outcome`.
+    Loop* m_loop;                       ///< The loop which runs the continuation, if bound.
+    bool m_holds_loop;                  ///< Flag indicating this state is keeping `m_loop` alive.
+};
+
+}
+}
+}
@@ -1,9 +1,5 @@
 #pragma once
 
-#include <atomic>
-#include <functional>
-#include <memory>
-
 #include "lw/event/Promise.hpp"
 
 namespace lw {
@@ -15,11 +11,15 @@ public:
     /// @brief Default construction.
     Promise( void ):
         m_state( new _SharedState() )
+    {}
+
+    // ---------------------------------------------------------------------- //
+
+    /// @copydoc Promise::Promise(Loop&)
+    explicit Promise( Loop& loop ):
+        Promise()
     {
-        m_state->resolved   = false;
-        m_state->rejected   = false;
-        m_state->resolve    = nullptr;
-        m_state->reject     = nullptr;
+        m_state->bind( loop );
     }
 
     // ---------------------------------------------------------------------- //
@@ -30,11 +30,9 @@ public:
     // ---------------------------------------------------------------------- //
 
     /// @brief Moves the promise from `other` to `this`.
-    Promise( Promise&& other ):
+    Promise( Promise&& other ) noexcept:
         m_state( std::move( other.m_state ) )
-    {
-        other.m_state = nullptr;
-    }
+    {}
 
     // ---------------------------------------------------------------------- //
 
@@ -44,23 +42,28 @@ public:
     // ---------------------------------------------------------------------- //
 
     /// @brief Resolves the promise as a success.
+    ///
+    /// If nothing has been chained onto the future yet, the resolution is held until something is.
     void resolve( void ){
-        m_state->resolved = true;
-        if( m_state->resolve ){
-            m_state->resolve();
-        }
+        m_state->resolve( _details::Nothing() );
     }
 
     // ---------------------------------------------------------------------- //
 
     /// @brief Rejects the promise as a failure.
-    void reject( const error::Exception& err ){
-        m_state->rejected = true;
-        if( m_state->reject ){
-            m_state->reject( err );
-        }
-        else {
-            throw err;
+    ///
+    /// If nothing has been chained onto the future yet, the error is held until something is.
+    /// Exceptions convert to `error::Error` implicitly.
+    ///
+    /// As with `Promise<T>::reject`, a rejection nobody can observe is raised here rather than
+    /// lost, so code rejecting on behalf of consumers which may have dropped their futures must
+    /// catch it.
+    ///
+    /// @throws error::Exception The error, via `error::Error::raise`, if the future was taken and
+    ///                          dropped without a handler chained.
+    void reject( const error::Error& err ){
+        if( !m_state->reject( err ) ){
+            err.raise();
         }
     }
 
@@ -73,10 +76,7 @@ public:
         if( !is_finished() ){
             throw PromiseError( 1, "Cannot reset an unfinished promise." );
         }
-        m_state->resolved   = false;
-        m_state->rejected   = false;
-        m_state->resolve    = nullptr;
-        m_state->reject     = nullptr;
+        m_state->reset();
     }
 
     // ---------------------------------------------------------------------- //
@@ -108,9 +108,8 @@ public:
     // ---------------------------------------------------------------------- //
 
     /// @brief Moves the promise from `other` into `this`.
-    Promise& operator=( Promise&& other ){
+    Promise& operator=( Promise&& other ) noexcept {
         m_state = std::move( other.m_state );
-        other.m_state = nullptr;
         return *this;
     }
 
@@ -121,13 +120,8 @@ private:
     // ---------------------------------------------------------------------- //
 
     /// @brief The container for the shared state between promises and futures.
-    struct _SharedState {
-        std::atomic_bool resolved;
-        std::atomic_bool rejected;
-        std::function< void( void ) > resolve;
-        std::function< void( const error::Exception& ) > reject;
-    };
-    typedef std::shared_ptr< _SharedState > _SharedStatePtr;
+    typedef _details::SharedState< void > _SharedState;
+    typedef _details::IntrusivePtr< _SharedState > _SharedStatePtr;
 
     // ---------------------------------------------------------------------- //
 
@@ -189,10 +183,29 @@ public:
 
     // ---------------------------------------------------------------------- //
 
+    /// @brief Converts this future into one which may have many continuations.
+    SharedFuture< void > share( void );
+
+    // ---------------------------------------------------------------------- //
+
+    /// @copydoc Future::then_on
+    template< typename Func >
+    auto then_on( Executor& executor, Func&& func );
+
+    // ---------------------------------------------------------------------- //
+
+    /// @copydoc Future::then(const Priority, Func&&)
+    template< typename Func >
+    auto then( const Priority priority, Func&& func );
+
+    // ---------------------------------------------------------------------- //
+
 private:
     template< typename Type >
     friend class ::lw::event::Promise;
 
+    friend struct ::lw::event::_details::FutureAccess;
+
     // ---------------------------------------------------------------------- //
 
     /// @brief Only `Promise`s can construct us.
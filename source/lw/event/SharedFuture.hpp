@@ -0,0 +1,239 @@
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lw/error.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace _details {
+    /// @internal
+    /// @brief Calls a shared future's resolve handler with the shared value.
+    template<typename Resolve, typename Value>
+    inline auto call_shared(Resolve& resolve, const Value& value){
+        return resolve(value);
+    }
+
+    template<typename Resolve>
+    inline auto call_shared(Resolve& resolve, const Nothing&){
+        return resolve();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The state behind a `SharedFuture`, holding the outcome for every consumer.
+    ///
+    /// @tparam T The promised type.
+    template<typename T>
+    class SharedFutureState : public RefCounted<SharedFutureState<T>> {
+    public:
+        typedef typename StoredValue<T>::type value_type;
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Makes a future which is finished when the shared one is.
+        ///
+        /// The future is already finished if the outcome is known.
+        Future<> wait(void){
+            Promise<> promise;
+            auto future = promise.future();
+            if (m_value) {
+                promise.resolve();
+            }
+            else if (m_error) {
+                promise.reject(*m_error);
+            }
+            else {
+                m_waiters.push_back(std::move(promise));
+            }
+            return future;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Keeps the outcome of the wrapped future and wakes every waiter.
+        ///
+        /// A consumer which dropped its future without handling a rejection raises it, as with any
+        /// `Future`. That must not strand the other consumers, so the first such error is rethrown
+        /// once every waiter has been woken.
+        void settle(value_type* value, const error::Error* err){
+            if (value) {
+                m_value.reset(new value_type(std::move(*value)));
+            }
+            else {
+                m_error.reset(new error::Error(*err));
+            }
+
+            // Waiters are taken off of the state first so new ones added by a continuation are
+            // finished straight away rather than appended during the iteration.
+            std::vector<Promise<>> waiters(std::move(m_waiters));
+            std::exception_ptr raised;
+            for (Promise<>& waiter : waiters) {
+                try {
+                    if (m_value) {
+                        waiter.resolve();
+                    }
+                    else {
+                        waiter.reject(*m_error);
+                    }
+                }
+                catch (...) {
+                    if (!raised) {
+                        raised = std::current_exception();
+                    }
+                }
+            }
+            if (raised) {
+                std::rethrow_exception(raised);
+            }
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Indicates if the outcome is known.
+        bool is_ready(void) const {
+            return m_value || m_error;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief The resolved value, only valid once resolved.
+        const value_type& value(void) const {
+            return *m_value;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    private:
+        std::unique_ptr<value_type> m_value;    ///< The resolved value, if resolved.
+        std::unique_ptr<error::Error> m_error;  ///< The error, if rejected.
+        std::vector<Promise<>> m_waiters;       ///< Promises waiting for the outcome.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Continuation passing the wrapped future's outcome to the shared state.
+    template<typename T>
+    struct SharedFutureContinuation {
+        typedef typename StoredValue<T>::type value_type;
+
+        explicit SharedFutureContinuation(SharedFutureState<T>* state):
+            state(state)
+        {}
+
+        void operator()(value_type* value, const error::Error* err){
+            state->settle(value, err);
+        }
+
+        IntrusivePtr<SharedFutureState<T>> state;
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief A future which may have any number of continuations.
+///
+/// Every continuation receives the one resolved value by `const T&`, so it is never copied. Copies
+/// of a `SharedFuture` refer to the same outcome. Continuations added after the outcome is known
+/// are called immediately. Like `Future`, shared futures must only be used from the thread running
+/// their loop.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::event::SharedFuture<Config> config = load_config(loop).share();
+///
+///     // For each request...
+///     config.then([](const Config& config){
+///         // ...
+///     });
+/// @endcode
+///
+/// @tparam T The promised type.
+template<typename T = void>
+class SharedFuture {
+public:
+    /// @brief The type promised by this future.
+    typedef T result_type;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Takes over the given future.
+    ///
+    /// @param future The future to share.
+    explicit SharedFuture(Future<T>&& future):
+        m_state(new _SharedState())
+    {
+        _details::FutureAccess::state(future)
+            .template then<_details::SharedFutureContinuation<T>>(m_state.get());
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if the shared future has been resolved or rejected.
+    bool is_ready(void) const {
+        return m_state->is_ready();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Chains a functor onto the shared future.
+    ///
+    /// @param resolve A functor taking `const T&`, or nothing for `SharedFuture<void>`. It may
+    ///                return a value, a `Future`, or nothing just as with `Future::then`.
+    ///
+    /// @return A future for the result of `resolve`.
+    template<typename Resolve>
+    auto then(Resolve&& resolve) const {
+        return then(std::forward<Resolve>(resolve), nullptr);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Chains a functor onto the shared future, with a handler for rejection.
+    ///
+    /// @param resolve A functor taking `const T&`, or nothing for `SharedFuture<void>`.
+    /// @param reject  A functor taking the error, as with `Future::then`.
+    ///
+    /// @return A future for the result of `resolve`.
+    template<typename Resolve, typename Reject>
+    auto then(Resolve&& resolve, Reject&& reject) const {
+        return m_state->wait().then(
+            [state = m_state, resolve = std::forward<Resolve>(resolve)]() mutable {
+                return _details::call_shared(resolve, state->value());
+            },
+            std::forward<Reject>(reject)
+        );
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    typedef _details::SharedFutureState<T> _SharedState;
+
+    _details::IntrusivePtr<_SharedState> m_state;   ///< The outcome shared by every copy.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename T>
+SharedFuture<T> Future<T>::share(void){
+    return SharedFuture<T>(std::move(*this));
+}
+
+inline SharedFuture<void> Future<void>::share(void){
+    return SharedFuture<void>(std::move(*this));
+}
+
+}
+}
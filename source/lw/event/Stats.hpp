@@ -0,0 +1,310 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef LW_ENABLE_EVENT_STATS
+#include <atomic>
+#include <memory>
+#endif
+
+namespace lw {
+namespace event {
+
+/// @brief A histogram of durations in power-of-two nanosecond buckets.
+///
+/// Bucket `0` counts durations under 2ns and bucket `i` counts durations in `[2^i, 2^(i+1))`
+/// nanoseconds. The last bucket also counts everything longer.
+class LatencyHistogram {
+public:
+    /// @brief The number of buckets in the histogram.
+    static constexpr std::size_t bucket_count = 32;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    LatencyHistogram(void):
+        m_buckets{}
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Finds the bucket a duration belongs in.
+    ///
+    /// @param nanoseconds The duration in nanoseconds.
+    ///
+    /// @return The index of the bucket for the duration.
+    static std::size_t bucket_for(std::uint64_t nanoseconds){
+        std::size_t bucket = 0;
+        while (nanoseconds > 1 && bucket < bucket_count - 1) {
+            nanoseconds >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The smallest duration, in nanoseconds, which is above the given bucket.
+    static std::uint64_t upper_bound(const std::size_t bucket){
+        return std::uint64_t(1) << (bucket + 1);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Counts one duration.
+    template<typename Rep, typename Period>
+    void record(const std::chrono::duration<Rep, Period> duration){
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        add(bucket_for(nanoseconds > 0 ? nanoseconds : 0));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Adds to the count of a bucket.
+    ///
+    /// @param bucket   The index of the bucket to add to.
+    /// @param count    The amount to add.
+    void add(const std::size_t bucket, const std::uint64_t count = 1){
+        m_buckets[bucket] += count;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of durations counted in the given bucket.
+    std::uint64_t bucket(const std::size_t bucket) const {
+        return m_buckets[bucket];
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of durations counted in all buckets.
+    std::uint64_t count(void) const {
+        std::uint64_t total = 0;
+        for (std::uint64_t bucket : m_buckets) {
+            total += bucket;
+        }
+        return total;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Estimates a percentile of the counted durations.
+    ///
+    /// @param percent The percentile to find, from `0` to `100`.
+    ///
+    /// @return The upper bound of the bucket holding the percentile, or zero if nothing has been
+    /// counted.
+    std::chrono::nanoseconds percentile(const double percent) const {
+        const std::uint64_t total = count();
+        if (total == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+
+        const double target = total * percent / 100.0;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += m_buckets[i];
+            if (seen >= target && seen > 0) {
+                return std::chrono::nanoseconds(upper_bound(i));
+            }
+        }
+        return std::chrono::nanoseconds(upper_bound(bucket_count - 1));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    std::array<std::uint64_t, bucket_count> m_buckets; ///< The count for each bucket.
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Timings of a `Loop`'s iterations, see `Loop::monitor_iterations`.
+///
+/// Each iteration is split into time spent waiting in poll for something to happen and time spent
+/// busy running callbacks. With libuv older than 1.39 the time spent running I/O callbacks during
+/// the poll counts as waiting.
+struct IterationStats {
+    std::uint64_t iterations;               ///< Iterations run while monitored.
+    double iterations_per_second;           ///< Iterations per second the loop was running.
+    std::chrono::nanoseconds poll_time;     ///< Total time spent waiting in poll.
+    std::chrono::nanoseconds callback_time; ///< Total time spent running callbacks.
+    LatencyHistogram callback_phase;        ///< Time spent running callbacks, per iteration.
+};
+
+#ifdef LW_ENABLE_EVENT_STATS
+
+/// @brief A snapshot of the promise machinery's activity on one `Loop`.
+///
+/// Only available when built with `LW_ENABLE_EVENT_STATS` defined (`./setup.sh --event-stats`).
+struct LoopStats {
+    std::size_t live_states;            ///< Promise shared states currently alive.
+    std::uint64_t states_created;       ///< Promise shared states created since the loop was.
+    double allocations_per_second;      ///< Average rate of shared state creation.
+    std::size_t max_chain_depth;        ///< Most continuations run from a single resolution.
+    std::size_t unresolved_at_exit;     ///< Unfinished promises when `Loop::run` last returned.
+    LatencyHistogram resolve_latency;   ///< Time from resolve or reject to the continuation.
+};
+
+namespace _details {
+    /// @internal
+    /// @brief The live counters behind `LoopStats`.
+    ///
+    /// Promises are counted against the loop which is current on the thread that creates them:
+    /// the loop being run, otherwise the most recently constructed one. Counters are atomic as
+    /// promises bound to a loop may be finished from other threads.
+    class StatsCounters {
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        StatsCounters(void):
+            live_states(0),
+            pending_states(0),
+            states_created(0),
+            max_chain_depth(0),
+            unresolved_at_exit(0),
+            latency{},
+            started(clock::now())
+        {}
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief The counters of the loop current on this thread, if any.
+        static std::shared_ptr<StatsCounters>& current(void){
+            static thread_local std::shared_ptr<StatsCounters> counters;
+            return counters;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Records the number of continuations run from one resolution.
+        void record_chain(const std::size_t depth){
+            std::size_t max = max_chain_depth.load(std::memory_order_relaxed);
+            while (depth > max && !max_chain_depth.compare_exchange_weak(max, depth)) {}
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Records the time between a promise finishing and its continuation running.
+        void record_latency(const clock::duration duration){
+            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+            latency[LatencyHistogram::bucket_for(nanoseconds.count())].fetch_add(
+                1,
+                std::memory_order_relaxed
+            );
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Makes a snapshot of the counters.
+        LoopStats snapshot(void) const {
+            LoopStats stats;
+            stats.live_states           = live_states.load();
+            stats.states_created        = states_created.load();
+            stats.max_chain_depth       = max_chain_depth.load();
+            stats.unresolved_at_exit    = unresolved_at_exit.load();
+
+            std::chrono::duration<double> elapsed = clock::now() - started;
+            stats.allocations_per_second =
+                elapsed.count() > 0 ? stats.states_created / elapsed.count() : 0.0;
+
+            for (std::size_t i = 0; i < LatencyHistogram::bucket_count; ++i) {
+                stats.resolve_latency.add(i, latency[i].load(std::memory_order_relaxed));
+            }
+            return stats;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        std::atomic<std::size_t> live_states;           ///< Shared states alive.
+        std::atomic<std::size_t> pending_states;        ///< Shared states alive and unfinished.
+        std::atomic<std::uint64_t> states_created;      ///< Shared states ever created.
+        std::atomic<std::size_t> max_chain_depth;       ///< Longest run of continuations.
+        std::atomic<std::size_t> unresolved_at_exit;    ///< Pending states at end of `run`.
+
+        /// @brief Counts for each bucket of the latency histogram.
+        std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucket_count> latency;
+
+        clock::time_point started;  ///< When counting began.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Counts a promise shared state against the current loop's stats.
+    class StateStats {
+    protected:
+        StateStats(void):
+            m_counters(StatsCounters::current()),
+            m_finished(false)
+        {
+            if (m_counters) {
+                ++m_counters->live_states;
+                ++m_counters->pending_states;
+                ++m_counters->states_created;
+            }
+        }
+
+        ~StateStats(void){
+            if (m_counters) {
+                --m_counters->live_states;
+                if (!m_finished) {
+                    --m_counters->pending_states;
+                }
+            }
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Marks the state as finished, starting the latency measurement.
+        void _stats_finished(void){
+            m_finished_at = StatsCounters::clock::now();
+            if (m_counters && !m_finished) {
+                --m_counters->pending_states;
+            }
+            m_finished = true;
+        }
+
+        /// @brief Marks the state as pending again after being reset.
+        void _stats_reset(void){
+            if (m_counters && m_finished) {
+                ++m_counters->pending_states;
+            }
+            m_finished = false;
+        }
+
+        /// @brief Records the latency as the continuation is about to be called.
+        void _stats_continued(void){
+            if (m_counters) {
+                m_counters->record_latency(StatsCounters::clock::now() - m_finished_at);
+            }
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    private:
+        std::shared_ptr<StatsCounters> m_counters;      ///< The loop stats counted against.
+        StatsCounters::clock::time_point m_finished_at; ///< When the state was finished.
+        bool m_finished;                                ///< Flag indicating it was finished.
+    };
+}
+
+#else
+
+namespace _details {
+    /// @internal
+    /// @brief Stats hooks which compile away when `LW_ENABLE_EVENT_STATS` is not defined.
+    class StateStats {
+    protected:
+        void _stats_finished(void){}
+        void _stats_reset(void){}
+        void _stats_continued(void){}
+    };
+}
+
+#endif
+
+}
+}
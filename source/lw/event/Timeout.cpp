@@ -1,22 +1,111 @@
 
-#include <cstdlib>
 #include <uv.h>
 
+#include "lw/event/HandlePool.hpp"
 #include "lw/event/Timeout.hpp"
 #include "lw/event/Timeout.impl.hpp"
+#include "lw/event/TimerWheel.hpp"
+#include "lw/memory/FreeList.hpp"
 
 namespace lw {
 namespace event {
 
+namespace {
+    /// @brief A bare `wait` on a timing wheel, which frees itself once settled.
+    ///
+    /// This is all a pending `wait` costs on a wheel, taken from a thread-local
+    /// pool.
+    class WheelWait : public TimerWheel::Node {
+    public:
+        static void* operator new( std::size_t ){
+            return memory::FreeList< WheelWait >::allocate();
+        }
+
+        static void operator delete( void* ptr ){
+            memory::FreeList< WheelWait >::deallocate( ptr );
+        }
+
+        // ------------------------------------------------------------------ //
+
+        Promise<> promise;
+        std::unique_ptr< CancellationRegistration > cancellation;
+
+        // ------------------------------------------------------------------ //
+
+    protected:
+        void expire( void ) override {
+            Promise<> settled = std::move( promise );
+            delete this;
+            settled.resolve();
+        }
+
+        void discard( void ) override {
+            delete this;
+        }
+    };
+
+    // ---------------------------------------------------------------------- //
+
+    Future<> _wheel_wait(
+        TimerWheel& wheel,
+        const Timeout::resolution& delay,
+        const CancellationToken& token
+    ){
+        if( token.is_cancelled() ){
+            Promise<> promise;
+            promise.reject( CancelledError( 1, "Timeout cancelled." ) );
+            return promise.future();
+        }
+
+        WheelWait* wait = new WheelWait();
+        auto future = wait->promise.future();
+        wheel.arm( *wait, delay );
+        if( token.can_be_cancelled() ){
+            wait->cancellation.reset( new CancellationRegistration(
+                token.on_cancel([ &wheel, wait ](){
+                    wheel.cancel( *wait );
+                    Promise<> settled = std::move( wait->promise );
+                    delete wait;
+                    settled.reject( CancelledError( 1, "Timeout cancelled." ) );
+                })
+            ) );
+        }
+        return future;
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
 struct Timeout::_State : public std::enable_shared_from_this< _State >{
+    /// @brief The state's place on a timing wheel.
+    struct WheelNode : public TimerWheel::Node {
+        void expire( void ) override {
+            Timeout::_fire( *state );
+        }
+
+        void discard( void ) override {
+            // The wheel is going away, drop the task and its state reference.
+            state->wheel = nullptr;
+            auto task = std::move( state->task );
+            state->task = nullptr;
+        }
+
+        _State* state;
+    };
+
     _State( Loop& loop );
     ~_State( void );
 
     event::Loop& loop;
     std::atomic_bool triggered;
-    uv_timer_s* handle;
+    uv_timer_s* handle;             ///< The libuv timer, unless on a wheel.
+    TimerWheel* wheel;              ///< The timing wheel, if the loop uses one.
+    WheelNode node;                 ///< The state's node on the wheel.
+    resolution interval;            ///< The wheel's repeat interval, or zero.
     std::shared_ptr< Promise<> > promise;
-    std::function< void( bool ) > task;
+    UniqueFunction< void( bool ) > task;
+    repeat_callback callback;
+    CancellationRegistration cancellation;
 };
 
 // -------------------------------------------------------------------------- //
@@ -30,11 +119,17 @@ Timeout::Timeout( Loop& loop ):
 Timeout::_State::_State( Loop& _loop ):
     loop( _loop ),
     triggered( false ),
-    handle( (uv_timer_t*)std::malloc( sizeof( uv_timer_t ) ) ),
+    handle( nullptr ),
+    wheel( _loop.timer_wheel() ),
+    interval( 0 ),
     promise( std::make_shared< Promise<> >() )
 {
-    uv_timer_init( loop.lowest_layer(), handle );
-    handle->data = (void*)this;
+    node.state = this;
+    if( !wheel ){
+        handle = HandlePool::allocate< uv_timer_t >();
+        uv_timer_init( loop.lowest_layer(), handle );
+        handle->data = (void*)this;
+    }
 }
 
 // -------------------------------------------------------------------------- //
@@ -42,16 +137,21 @@ Timeout::_State::_State( Loop& _loop ):
 Timeout::_State::~_State( void ){
     if( handle ){
         uv_timer_stop( handle );
-        std::free( handle );
+        HandlePool::close( (uv_handle_t*)handle );
         handle = nullptr;
     }
+    else if( wheel ){
+        wheel->cancel( node );
+    }
 }
 
 // -------------------------------------------------------------------------- //
 
 Future<> Timeout::start( const resolution& delay ){
+    _reset_promise();
     auto state = m_state;
     m_state->task = [ state ]( bool cancel ) mutable {
+        state->cancellation.reset();
         if( cancel ){
             state->promise->reject( TimeoutError( 1, "Timeout cancelled." ) );
         }
@@ -60,37 +160,51 @@ Future<> Timeout::start( const resolution& delay ){
         }
         state.reset();
     };
-    uv_timer_start( m_state->handle, &Timeout::_timer_cb, delay.count(), 0 );
+    _arm( delay, resolution( 0 ) );
     return m_state->promise->future();
 }
 
 // -------------------------------------------------------------------------- //
 
-Future<> Timeout::repeat( const resolution& interval, const repeat_callback& cb ){
+Future<> Timeout::start(
+    const resolution& delay,
+    const CancellationToken& token
+){
+    auto future = start( delay );
+    std::weak_ptr< _State > weak_state = m_state;
+    m_state->cancellation = token.on_cancel([ weak_state ](){
+        if( auto state = weak_state.lock() ){
+            Timeout( state )._cancel();
+        }
+    });
+    return future;
+}
+
+// -------------------------------------------------------------------------- //
+
+Future<> Timeout::repeat( const resolution& interval, repeat_callback cb ){
+    _reset_promise();
     auto state = m_state;
-    m_state->task = [ state, cb ]( bool cancel ) mutable {
+    m_state->callback = std::move( cb );
+    m_state->task = [ state ]( bool cancel ) mutable {
         if( cancel ){
+            state->callback = nullptr;
             state->promise->resolve();
             state.reset();
         }
         else {
             Timeout timeout( state );
-            cb( timeout );
+            state->callback( timeout );
         }
     };
-    uv_timer_start(
-        m_state->handle,
-        &Timeout::_timer_cb,
-        interval.count(),
-        interval.count()
-    );
+    _arm( interval, interval );
     return m_state->promise->future();
 }
 
 // -------------------------------------------------------------------------- //
 
 void Timeout::stop( void ){
-    uv_timer_stop( m_state->handle );
+    _disarm();
     if( m_state->task ){
         m_state->task( true ); // true == cancelled
         m_state->task = nullptr;
@@ -99,10 +213,104 @@ void Timeout::stop( void ){
 
 // -------------------------------------------------------------------------- //
 
+void Timeout::unref( void ){
+    if( m_state->wheel ){
+        m_state->wheel->unref( m_state->node );
+    }
+    else {
+        uv_unref( (uv_handle_t*)m_state->handle );
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+void Timeout::_reset_promise( void ){
+    // A finished promise holds on to its outcome, so restarting the timeout needs a fresh one.
+    if( m_state->promise->is_finished() ){
+        m_state->promise->reset();
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+void Timeout::_cancel( void ){
+    _disarm();
+    if( m_state->task ){
+        // The task holds a reference to the state, drop it without running it.
+        auto task = std::move( m_state->task );
+        m_state->task = nullptr;
+        m_state->promise->reject( CancelledError( 1, "Timeout cancelled." ) );
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+void Timeout::_arm( const resolution& delay, const resolution& interval ){
+    if( m_state->wheel ){
+        m_state->interval = interval;
+        m_state->wheel->arm( m_state->node, delay );
+    }
+    else {
+        uv_timer_start(
+            m_state->handle,
+            &Timeout::_timer_cb,
+            delay.count(),
+            interval.count()
+        );
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
+void Timeout::_disarm( void ){
+    if( m_state->wheel ){
+        m_state->interval = resolution( 0 );
+        m_state->wheel->cancel( m_state->node );
+    }
+    else {
+        uv_timer_stop( m_state->handle );
+    }
+}
+
+// -------------------------------------------------------------------------- //
+
 void Timeout::_timer_cb( uv_timer_t* handle ){
-    _State* state = (_State*)handle->data;
-    state->triggered = true;
-    state->task( false ); // false == not cancelled
+    _fire( *(_State*)handle->data );
+}
+
+// -------------------------------------------------------------------------- //
+
+void Timeout::_fire( _State& state ){
+    // Wheel nodes are disarmed when they expire, so repeats go back on first.
+    if( state.wheel && state.interval.count() > 0 ){
+        state.wheel->arm( state.node, state.interval );
+    }
+    state.triggered = true;
+    state.task( false ); // false == not cancelled
+}
+
+// -------------------------------------------------------------------------- //
+
+Future<> wait( Loop& loop, const Timeout::resolution& delay ){
+    if( TimerWheel* wheel = loop.timer_wheel() ){
+        return _wheel_wait( *wheel, delay, CancellationToken() );
+    }
+    Timeout timeout( loop );
+    return timeout.start( delay );
+}
+
+// -------------------------------------------------------------------------- //
+
+Future<> wait(
+    Loop& loop,
+    const Timeout::resolution& delay,
+    const CancellationToken& token
+){
+    if( TimerWheel* wheel = loop.timer_wheel() ){
+        return _wheel_wait( *wheel, delay, token );
+    }
+    Timeout timeout( loop );
+    return timeout.start( delay, token );
 }
 
 }
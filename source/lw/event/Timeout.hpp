@@ -4,8 +4,10 @@
 #include <chrono>
 #include <memory>
 
+#include "lw/event/Cancellation.hpp"
 #include "lw/event/Loop.hpp"
 #include "lw/event/Promise.hpp"
+#include "lw/event/UniqueFunction.hpp"
 
 struct uv_timer_s;
 
@@ -23,7 +25,7 @@ public:
     /// @brief Callback type used for repeating timeouts.
     ///
     /// @param timeout A reference to the repeating `Timeout`.
-    typedef std::function< void( Timeout& timeout ) > repeat_callback;
+    typedef UniqueFunction< void( Timeout& timeout ) > repeat_callback;
 
     // ---------------------------------------------------------------------- //
 
@@ -41,6 +43,17 @@ public:
     /// @return A future that will be resolved after the time has passed.
     Future<> start( const resolution& delay );
 
+    /// @brief Schedules the event to happen in the future unless cancelled.
+    ///
+    /// Cancelling the token stops the timer and rejects the future with a
+    /// `CancelledError`.
+    ///
+    /// @param delay How long to wait before resolving.
+    /// @param token The token to stop the timer with.
+    ///
+    /// @return A future that will be resolved after the time has passed.
+    Future<> start( const resolution& delay, const CancellationToken& token );
+
     // ---------------------------------------------------------------------- //
 
     /// @brief Schedules a callback to be called repeatedly.
@@ -52,7 +65,7 @@ public:
     /// @param cb       The callback to execute repeatedly.
     ///
     /// @return A future that will be resolved when the repeating is stopped.
-    Future<> repeat( const resolution& interval, const repeat_callback& cb );
+    Future<> repeat( const resolution& interval, repeat_callback cb );
 
     // ---------------------------------------------------------------------- //
 
@@ -66,6 +79,15 @@ public:
 
     // ---------------------------------------------------------------------- //
 
+    /// @brief Lets the loop exit while this timeout is pending.
+    ///
+    /// By default a pending timeout keeps `Loop::run` from returning. This is
+    /// for background timers, such as expiring cache entries, which should not
+    /// hold the loop open on their own.
+    void unref( void );
+
+    // ---------------------------------------------------------------------- //
+
 private:
     struct _State; ///< Type used for managing internal state.
 
@@ -76,6 +98,32 @@ private:
     /// @param handle The timer handle that fired.
     static void _timer_cb( uv_timer_s* handle );
 
+    /// @brief Re-arms a repeating wheel timer and triggers the callback.
+    ///
+    /// @param state The state of the timeout that fired.
+    static void _fire( _State& state );
+
+    // ---------------------------------------------------------------------- //
+
+    /// @brief Starts the timer on the libuv timer or the loop's timing wheel.
+    ///
+    /// @param delay    The time until the first trigger.
+    /// @param interval The time between triggers after that, or zero for once.
+    void _arm( const resolution& delay, const resolution& interval );
+
+    /// @brief Stops the timer, wherever it is running.
+    void _disarm( void );
+
+    // ---------------------------------------------------------------------- //
+
+    /// @brief Makes the promise ready for another run if it has already finished.
+    void _reset_promise( void );
+
+    // ---------------------------------------------------------------------- //
+
+    /// @brief Stops the timer and rejects the promise with a `CancelledError`.
+    void _cancel( void );
+
     // ---------------------------------------------------------------------- //
 
     /// @brief Constructs a timeout around existing state.
@@ -101,6 +149,20 @@ private:
 /// @return A future that will be resolved after time has passed.
 Future<> wait( Loop& loop, const Timeout::resolution& delay );
 
+/// @brief Starts a timeout that can be cancelled before it resolves.
+///
+/// @param loop     The event loop to use for waiting.
+/// @param delay    The amount of time to wait. Up to millisecond resolution.
+/// @param token    The token to stop the timer with.
+///
+/// @return A future that will be resolved after time has passed, or rejected
+///         with a `CancelledError` if the token is cancelled first.
+Future<> wait(
+    Loop& loop,
+    const Timeout::resolution& delay,
+    const CancellationToken& token
+);
+
 // -------------------------------------------------------------------------- //
 
 /// @brief Waits until the provided point in time before resolving.
@@ -6,22 +6,18 @@
 namespace lw {
 namespace event {
 
-inline Future<> wait( Loop& loop, const Timeout::resolution& delay ){
-    Timeout timeout( loop );
-    return timeout.start( delay );
-}
-
-// -------------------------------------------------------------------------- //
-
 template< class Clock, class Duration >
 Future<> wait_until(
     Loop& loop,
     const std::chrono::time_point< Clock, Duration >& when
 ){
-    return wait(
-        loop,
-        std::chrono::duration_cast< Timeout::resolution >( when - Clock::now() )
-    );
+    // Round up so the wait never ends before the given time.
+    const auto delay = when - Clock::now();
+    auto rounded = std::chrono::duration_cast< Timeout::resolution >( delay );
+    if( rounded < delay ){
+        rounded += Timeout::resolution( 1 );
+    }
+    return wait( loop, rounded );
 }
 
 // -------------------------------------------------------------------------- //
@@ -0,0 +1,270 @@
+
+#include <algorithm>
+#include <uv.h>
+
+#include "lw/event/HandlePool.hpp"
+#include "lw/event/TimerWheel.hpp"
+
+namespace lw {
+namespace event {
+
+TimerWheel::TimerWheel(Loop& loop):
+    m_loop(loop.lowest_layer()),
+    m_timer(HandlePool::allocate<uv_timer_s>()),
+    m_current(uv_now(loop.lowest_layer())),
+    m_wakeup(0),
+    m_size(0),
+    m_referenced(0),
+    m_timer_referenced(true)
+{
+    std::fill(std::begin(m_root), std::end(m_root), nullptr);
+    for (auto& wheel : m_wheels) {
+        std::fill(std::begin(wheel), std::end(wheel), nullptr);
+    }
+    std::fill(std::begin(m_occupied), std::end(m_occupied), 0);
+
+    uv_timer_init(m_loop, m_timer);
+    m_timer->data = (void*)this;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TimerWheel::~TimerWheel(void){
+    uv_timer_stop(m_timer);
+    HandlePool::close((uv_handle_t*)m_timer);
+
+    auto discard_all = [this](Node*& slot){
+        while (Node* node = slot) {
+            _unlink(*node);
+            node->discard();
+        }
+    };
+    for (Node*& slot : m_root) {
+        discard_all(slot);
+    }
+    for (auto& wheel : m_wheels) {
+        for (Node*& slot : wheel) {
+            discard_all(slot);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::arm(Node& node, const std::chrono::milliseconds delay){
+    if (node.is_armed()) {
+        _unlink(node);
+    }
+    else {
+        ++m_size;
+        if (node.m_referenced) {
+            ++m_referenced;
+        }
+    }
+
+    const std::uint64_t expiry = uv_now(m_loop) + (delay.count() > 0 ? delay.count() : 0);
+    node.m_expiry = std::max(expiry, m_current + 1);
+    _place(node);
+    _update_ref();
+
+    // A node on a higher wheel never expires before the next turn of the first one, which the
+    // timer is always set for at the latest.
+    if (!uv_is_active((uv_handle_t*)m_timer) || node.m_expiry < m_wakeup) {
+        _schedule();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::cancel(Node& node){
+    if (!node.is_armed()) {
+        return;
+    }
+
+    _unlink(node);
+    --m_size;
+    if (node.m_referenced) {
+        --m_referenced;
+    }
+    _update_ref();
+    if (m_size == 0) {
+        uv_timer_stop(m_timer);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::unref(Node& node){
+    if (!node.m_referenced) {
+        return;
+    }
+
+    node.m_referenced = false;
+    if (node.is_armed()) {
+        --m_referenced;
+        _update_ref();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_place(Node& node){
+    const std::uint64_t delta = node.m_expiry - m_current;
+    Node** slot = nullptr;
+    if (delta < _root_size) {
+        const std::size_t index = node.m_expiry & (_root_size - 1);
+        m_occupied[index / 64] |= std::uint64_t(1) << (index % 64);
+        slot = &m_root[index];
+    }
+    else {
+        std::size_t level = 1;
+        while (level < _levels && delta >= (std::uint64_t(1) << _shift(level + 1))) {
+            ++level;
+        }
+
+        // Anything past the last wheel waits in its furthest slot and is placed again from there.
+        std::uint64_t when = node.m_expiry;
+        if (level == _levels) {
+            level = _levels - 1;
+            when = m_current + (std::uint64_t(1) << _shift(_levels)) - 1;
+        }
+        slot = &m_wheels[level - 1][(when >> _shift(level)) & (_level_size - 1)];
+    }
+
+    node.m_next = *slot;
+    if (node.m_next) {
+        node.m_next->m_prev = &node.m_next;
+    }
+    node.m_prev = slot;
+    *slot = &node;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_unlink(Node& node){
+    *node.m_prev = node.m_next;
+    if (node.m_next) {
+        node.m_next->m_prev = node.m_prev;
+    }
+    node.m_next = nullptr;
+    node.m_prev = nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_cascade(const std::size_t level, const std::size_t slot){
+    Node* node = m_wheels[level - 1][slot];
+    m_wheels[level - 1][slot] = nullptr;
+    while (node) {
+        Node* next = node->m_next;
+        _place(*node);
+        node = next;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+std::uint64_t TimerWheel::_next_tick(void){
+    const std::uint64_t mask = _root_size - 1;
+    const std::uint64_t turn = m_current & ~mask;
+    std::size_t index = (m_current & mask) + 1;
+    while (index < _root_size) {
+        std::uint64_t word = m_occupied[index / 64] >> (index % 64);
+        if (!word) {
+            index = (index / 64 + 1) * 64;
+            continue;
+        }
+        while (!(word & 1)) {
+            word >>= 1;
+            ++index;
+        }
+        if (m_root[index]) {
+            return turn + index;
+        }
+
+        // Slots are only marked free lazily, once they are found empty.
+        m_occupied[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+        ++index;
+    }
+    return turn + _root_size;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_advance(const std::uint64_t now){
+    while (m_current < now) {
+        const std::uint64_t next = _next_tick();
+        if (next > now) {
+            m_current = now;
+            break;
+        }
+        m_current = next;
+        _tick(next);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_tick(const std::uint64_t tick){
+    const std::size_t index = tick & (_root_size - 1);
+    if (index == 0) {
+        // Each wheel which turned over pours its next slot into the ones below, highest first.
+        std::size_t top = 1;
+        while (top < _levels - 1 && ((tick >> _shift(top)) & (_level_size - 1)) == 0) {
+            ++top;
+        }
+        for (std::size_t level = top; level > 0; --level) {
+            _cascade(level, (tick >> _shift(level)) & (_level_size - 1));
+        }
+    }
+
+    // Expiring a node may arm others, but never into the slot being emptied.
+    Node*& slot = m_root[index];
+    while (Node* node = slot) {
+        _unlink(*node);
+        --m_size;
+        if (node->m_referenced) {
+            --m_referenced;
+        }
+        node->expire();
+    }
+    m_occupied[index / 64] &= ~(std::uint64_t(1) << (index % 64));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_schedule(void){
+    if (m_size == 0) {
+        uv_timer_stop(m_timer);
+        return;
+    }
+
+    m_wakeup = _next_tick();
+    const std::uint64_t now = uv_now(m_loop);
+    uv_timer_start(m_timer, [](uv_timer_t* handle){
+        TimerWheel& wheel = *(TimerWheel*)handle->data;
+        wheel._advance(uv_now(wheel.m_loop));
+        wheel._update_ref();
+        wheel._schedule();
+    }, m_wakeup > now ? m_wakeup - now : 0, 0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void TimerWheel::_update_ref(void){
+    const bool referenced = m_referenced > 0;
+    if (referenced == m_timer_referenced) {
+        return;
+    }
+
+    m_timer_referenced = referenced;
+    if (referenced) {
+        uv_ref((uv_handle_t*)m_timer);
+    }
+    else {
+        uv_unref((uv_handle_t*)m_timer);
+    }
+}
+
+}
+}
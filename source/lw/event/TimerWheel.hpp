@@ -0,0 +1,174 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "lw/event/Loop.hpp"
+
+struct uv_timer_s;
+
+namespace lw {
+namespace event {
+
+/// @brief A hierarchical timing wheel which drives any number of timers from one libuv timer.
+///
+/// Timers are intrusive `TimerWheel::Node`s linked into slots of four wheels with millisecond
+/// ticks. The first wheel has 256 slots of one tick each, and each of the other three has 64
+/// slots covering a whole turn of the wheel below. Timers further out than that, about 18 hours,
+/// are parked in the last wheel and placed again when it comes round. Arming and cancelling a
+/// timer are constant time with no allocation, at the cost of waking the loop at least every
+/// 256 milliseconds while any timer is more than a turn of the first wheel away.
+///
+/// Enable it with `Loop::use_timer_wheel`, after which `Timeout`, `wait` and `repeat` on that loop
+/// all use it. The wheel must only be used from its loop's thread.
+class TimerWheel {
+public:
+    /// @brief A timer which can be armed on the wheel.
+    ///
+    /// Nodes are owned by whoever arms them, and must be cancelled before they are destroyed.
+    class Node {
+    public:
+        Node(void):
+            m_next(nullptr),
+            m_prev(nullptr),
+            m_expiry(0),
+            m_referenced(true)
+        {}
+
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Indicates if the node is waiting on a wheel.
+        bool is_armed(void) const {
+            return m_prev != nullptr;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    protected:
+        virtual ~Node(void){}
+
+        /// @brief Called by the wheel once the node's time has come, after disarming it.
+        virtual void expire(void) = 0;
+
+        /// @brief Called by the wheel for each armed node when the wheel is destroyed.
+        virtual void discard(void){}
+
+        // -------------------------------------------------------------------------------------- //
+
+    private:
+        friend class TimerWheel;
+
+        Node* m_next;           ///< The next node in the slot.
+        Node** m_prev;          ///< The pointer to this node, or null when not armed.
+        std::uint64_t m_expiry; ///< The tick the node expires on.
+        bool m_referenced;      ///< Flag indicating the node keeps the loop running.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Sets up a wheel driven by a timer on the given loop.
+    ///
+    /// @param loop The loop to run the timers on.
+    explicit TimerWheel(Loop& loop);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /// @brief Discards every armed node and closes the driving timer.
+    ~TimerWheel(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Arms the node to expire after the delay, re-arming it if it is already armed.
+    ///
+    /// As with libuv's timers, the delay is counted from the loop's cached time.
+    ///
+    /// @param node  The node to arm.
+    /// @param delay How long to wait before expiring the node.
+    void arm(Node& node, const std::chrono::milliseconds delay);
+
+    /// @brief Disarms the node if it is armed, without expiring it.
+    ///
+    /// @param node The node to cancel.
+    void cancel(Node& node);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Lets the loop exit while the node is armed.
+    ///
+    /// @param node The node which should not keep the loop running.
+    void unref(Node& node);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The number of armed nodes.
+    std::size_t size(void) const {
+        return m_size;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    static constexpr std::size_t _root_bits     = 8;    ///< Bits of the tick for the first wheel.
+    static constexpr std::size_t _level_bits    = 6;    ///< Bits of the tick for each other wheel.
+    static constexpr std::size_t _levels        = 4;    ///< The number of wheels.
+    static constexpr std::size_t _root_size     = std::size_t(1) << _root_bits;
+    static constexpr std::size_t _level_size    = std::size_t(1) << _level_bits;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Gives the lowest tick bit used to index the wheel at the given level.
+    static constexpr std::size_t _shift(const std::size_t level){
+        return level == 0 ? 0 : _root_bits + (level - 1) * _level_bits;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Links the node into the slot for its expiry, relative to the current tick.
+    void _place(Node& node);
+
+    /// @brief Removes the node from its slot.
+    void _unlink(Node& node);
+
+    /// @brief Places every node in the slot again, relative to the current tick.
+    void _cascade(const std::size_t level, const std::size_t slot);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief The next tick that needs processing, which is never past the first wheel's turn.
+    std::uint64_t _next_tick(void);
+
+    /// @brief Processes every tick up to and including `now`.
+    void _advance(const std::uint64_t now);
+
+    /// @brief Cascades the higher wheels if needed and expires the nodes due on the tick.
+    void _tick(const std::uint64_t tick);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Sets the driving timer for the next tick that needs processing.
+    void _schedule(void);
+
+    /// @brief Makes the driving timer keep the loop running only while referenced nodes are armed.
+    void _update_ref(void);
+
+    // ------------------------------------------------------------------------------------------ //
+
+    uv_loop_s* m_loop;                                  ///< The loop the timer runs on.
+    uv_timer_s* m_timer;                                ///< The timer which drives the wheel.
+    std::uint64_t m_current;                            ///< The last tick processed.
+    std::uint64_t m_wakeup;                             ///< The tick the timer is set for.
+    std::size_t m_size;                                 ///< The number of armed nodes.
+    std::size_t m_referenced;                           ///< The number of armed referenced nodes.
+    bool m_timer_referenced;                            ///< Flag indicating the timer is ref'd.
+    Node* m_root[_root_size];                           ///< The first wheel.
+    Node* m_wheels[_levels - 1][_level_size];           ///< The higher wheels.
+    std::uint64_t m_occupied[_root_size / 64];          ///< Slots of the first wheel in use.
+};
+
+}
+}
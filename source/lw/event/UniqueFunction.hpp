@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "lw/trait.hpp"
+
+namespace lw {
+namespace event {
+
+template<typename Signature, std::size_t Capacity = 48>
+class UniqueFunction;
+
+/// @brief A move-only functor wrapper which stores small functors inside itself.
+///
+/// Functors up to `Capacity` bytes which can be moved without throwing are constructed directly in
+/// the wrapper's buffer. Anything larger is boxed on the heap. Unlike `std::function`, the wrapped
+/// functor does not need to be copyable, so lambdas may capture move-only values such as buffers
+/// and promises.
+///
+/// The default capacity holds a lambda capturing a few pointers and two `std::shared_ptr`s.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::memory::Buffer data(1024);
+///     lw::event::UniqueFunction<void(void)> task = [data = std::move(data)](){
+///         // ...
+///     };
+/// @endcode
+///
+/// @tparam Result   The return type of the functor.
+/// @tparam Args     The argument types for the functor.
+/// @tparam Capacity The number of bytes available for inline storage.
+template<typename Result, typename... Args, std::size_t Capacity>
+class UniqueFunction<Result(Args...), Capacity> {
+public:
+    /// @brief The number of bytes available for functors stored inline.
+    static constexpr std::size_t capacity = Capacity;
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    /// @brief Determines if `Func` is a functor which can be wrapped.
+    template<typename Func, typename Decayed = typename std::decay<Func>::type>
+    struct _IsWrappable : public std::integral_constant<
+        bool,
+        !std::is_same<Decayed, UniqueFunction>::value &&
+        !std::is_same<Decayed, std::nullptr_t>::value &&
+        trait::is_callable<Decayed&(Args...)>::value
+    > {};
+
+    // ------------------------------------------------------------------------------------------ //
+
+public:
+    /// @brief Constructs an empty function.
+    UniqueFunction(void):
+        m_ops(nullptr)
+    {}
+
+    /// @copydoc UniqueFunction::UniqueFunction(void)
+    UniqueFunction(std::nullptr_t):
+        m_ops(nullptr)
+    {}
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Wraps the given functor.
+    ///
+    /// @tparam Func A functor type callable with `Args...`.
+    ///
+    /// @param func The functor to wrap.
+    template<
+        typename Func,
+        typename = typename std::enable_if<_IsWrappable<Func>::value>::type
+    >
+    UniqueFunction(Func&& func):
+        m_ops(nullptr)
+    {
+        emplace<typename std::decay<Func>::type>(std::forward<Func>(func));
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief No copying.
+    UniqueFunction(const UniqueFunction&) = delete;
+
+    /// @brief Moves the functor from `other` into `this`, leaving `other` empty.
+    UniqueFunction(UniqueFunction&& other) noexcept:
+        m_ops(other.m_ops)
+    {
+        if (m_ops) {
+            m_ops->move(&m_storage, &other.m_storage);
+            other.m_ops = nullptr;
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    ~UniqueFunction(void){
+        reset();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Constructs a new functor in place, destroying any currently held.
+    ///
+    /// @tparam Func     The type of functor to construct.
+    /// @tparam FuncArgs The constructor argument types.
+    ///
+    /// @param args The arguments to construct the functor with.
+    template<typename Func, typename... FuncArgs>
+    void emplace(FuncArgs&&... args){
+        reset();
+        _Ops<Func>::construct(&m_storage, std::forward<FuncArgs>(args)...);
+        m_ops = &_Ops<Func>::table;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Destroys the held functor, if any.
+    void reset(void){
+        if (m_ops) {
+            const _OpsTable* ops = m_ops;
+            m_ops = nullptr;
+            ops->destroy(&m_storage);
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Calls the held functor.
+    ///
+    /// The function must not be empty.
+    Result operator()(Args... args){
+        return m_ops->invoke(&m_storage, std::forward<Args>(args)...);
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Indicates if there is a functor held.
+    explicit operator bool(void) const {
+        return m_ops != nullptr;
+    }
+
+    /// @brief Indicates if the function is empty.
+    friend bool operator==(const UniqueFunction& func, std::nullptr_t){
+        return !func;
+    }
+
+    /// @copydoc operator==(const UniqueFunction&, std::nullptr_t)
+    friend bool operator==(std::nullptr_t, const UniqueFunction& func){
+        return !func;
+    }
+
+    /// @brief Indicates if the function holds a functor.
+    friend bool operator!=(const UniqueFunction& func, std::nullptr_t){
+        return (bool)func;
+    }
+
+    /// @copydoc operator!=(const UniqueFunction&, std::nullptr_t)
+    friend bool operator!=(std::nullptr_t, const UniqueFunction& func){
+        return (bool)func;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief No copying.
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    /// @brief Moves the functor from `other` into `this`, destroying the one held by `this`.
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.m_ops) {
+                other.m_ops->move(&m_storage, &other.m_storage);
+                m_ops = other.m_ops;
+                other.m_ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    /// @brief Destroys the held functor.
+    UniqueFunction& operator=(std::nullptr_t){
+        reset();
+        return *this;
+    }
+
+    /// @brief Replaces the held functor with `func`.
+    template<
+        typename Func,
+        typename = typename std::enable_if<_IsWrappable<Func>::value>::type
+    >
+    UniqueFunction& operator=(Func&& func){
+        emplace<typename std::decay<Func>::type>(std::forward<Func>(func));
+        return *this;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    typedef typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type _Storage;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Type-erased operations on the held functor.
+    struct _OpsTable {
+        Result (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* to, void* from);
+        void (*destroy)(void* storage);
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Determines if `Func` can be placed in the inline buffer.
+    template<typename Func>
+    struct _IsInline : public std::integral_constant<
+        bool,
+        sizeof(Func) <= Capacity &&
+        alignof(Func) <= alignof(_Storage) &&
+        std::is_nothrow_move_constructible<Func>::value
+    > {};
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Operations for functors stored in the inline buffer.
+    template<typename Func, bool = _IsInline<Func>::value>
+    struct _Ops {
+        template<typename... FuncArgs>
+        static void construct(void* storage, FuncArgs&&... args){
+            new (storage) Func(std::forward<FuncArgs>(args)...);
+        }
+
+        static Result invoke(void* storage, Args&&... args){
+            return (*static_cast<Func*>(storage))(std::forward<Args>(args)...);
+        }
+
+        static void move(void* to, void* from){
+            Func* func = static_cast<Func*>(from);
+            new (to) Func(std::move(*func));
+            func->~Func();
+        }
+
+        static void destroy(void* storage){
+            static_cast<Func*>(storage)->~Func();
+        }
+
+        static const _OpsTable table;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Operations for functors boxed on the heap.
+    template<typename Func>
+    struct _Ops<Func, false> {
+        template<typename... FuncArgs>
+        static void construct(void* storage, FuncArgs&&... args){
+            *static_cast<Func**>(storage) = new Func(std::forward<FuncArgs>(args)...);
+        }
+
+        static Result invoke(void* storage, Args&&... args){
+            return (**static_cast<Func**>(storage))(std::forward<Args>(args)...);
+        }
+
+        static void move(void* to, void* from){
+            *static_cast<Func**>(to) = *static_cast<Func**>(from);
+        }
+
+        static void destroy(void* storage){
+            delete *static_cast<Func**>(storage);
+        }
+
+        static const _OpsTable table;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    const _OpsTable* m_ops;   ///< Operations for the held functor, or `nullptr` if empty.
+    _Storage m_storage;         ///< Storage for the functor (or a pointer to it).
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+template<typename Result, typename... Args, std::size_t Capacity>
+template<typename Func, bool IsInline>
+const typename UniqueFunction<Result(Args...), Capacity>::_OpsTable
+UniqueFunction<Result(Args...), Capacity>::_Ops<Func, IsInline>::table = {
+    &_Ops::invoke,
+    &_Ops::move,
+    &_Ops::destroy
+};
+
+template<typename Result, typename... Args, std::size_t Capacity>
+template<typename Func>
+const typename UniqueFunction<Result(Args...), Capacity>::_OpsTable
+UniqueFunction<Result(Args...), Capacity>::_Ops<Func, false>::table = {
+    &_Ops::invoke,
+    &_Ops::move,
+    &_Ops::destroy
+};
+
+}
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "lw/error.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace _details {
+    /// @internal
+    /// @brief The state driving an asynchronous loop, shared by every one of its iterations.
+    ///
+    /// Each iteration's future is given a continuation which points back at this state instead of
+    /// chaining a new link, so memory stays flat however many iterations run. Iterations whose
+    /// futures are already finished are run in a plain loop rather than recursively.
+    ///
+    /// @tparam Derived The loop type, providing `_condition()` and `_step()`.
+    template<typename Derived>
+    class AsyncLoop : public RefCounted<Derived> {
+    public:
+        AsyncLoop(void):
+            m_running(false),
+            m_waiting(false),
+            m_failed(false)
+        {}
+
+        // -------------------------------------------------------------------------------------- //
+
+        Future<> future(void){
+            return m_promise.future();
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Runs iterations until one has to wait or the loop finishes.
+        void run(void){
+            m_running = true;
+            try {
+                while (!m_failed) {
+                    if (!_derived()._condition()) {
+                        m_promise.resolve();
+                        break;
+                    }
+
+                    m_waiting = true;
+                    _derived()._step();
+                    if (m_waiting) {
+                        break;
+                    }
+                }
+            }
+            catch (const error::Exception&) {
+                m_promise.reject(error::Error::current());
+            }
+            m_running = false;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @brief Receives the outcome of an iteration, continuing the loop if it succeeded.
+        void settle(const error::Error* err){
+            m_waiting = false;
+            if (err) {
+                m_failed = true;
+                m_promise.reject(*err);
+            }
+            else if (!m_running) {
+                run();
+            }
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    protected:
+        /// @brief Waits on the future from an iteration.
+        template<typename T>
+        void _wait(Future<T>&& future);
+
+        // -------------------------------------------------------------------------------------- //
+
+    private:
+        Derived& _derived(void){
+            return *static_cast<Derived*>(this);
+        }
+
+        bool m_running;         ///< Flag indicating `run` is on the stack.
+        bool m_waiting;         ///< Flag indicating the current iteration is unfinished.
+        bool m_failed;          ///< Flag indicating an iteration was rejected.
+        Promise<> m_promise;    ///< The promise for the whole loop.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Continuation passing an iteration's outcome back to its loop.
+    template<typename State, typename T>
+    struct AsyncLoopContinuation {
+        typedef typename StoredValue<T>::type value_type;
+
+        explicit AsyncLoopContinuation(State* state):
+            state(state)
+        {}
+
+        void operator()(value_type*, const error::Error* err){
+            state->settle(err);
+        }
+
+        IntrusivePtr<State> state;
+    };
+
+    template<typename Derived>
+    template<typename T>
+    void AsyncLoop<Derived>::_wait(Future<T>&& future){
+        FutureAccess::state(future).template then<AsyncLoopContinuation<Derived, T>>(
+            &_derived()
+        );
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Loop for `async_while`.
+    template<typename Condition, typename Body>
+    class WhileLoop : public AsyncLoop<WhileLoop<Condition, Body>> {
+    public:
+        template<typename ConditionArg, typename BodyArg>
+        WhileLoop(ConditionArg&& condition, BodyArg&& body):
+            m_condition(std::forward<ConditionArg>(condition)),
+            m_body(std::forward<BodyArg>(body))
+        {}
+
+    private:
+        friend class AsyncLoop<WhileLoop>;
+
+        bool _condition(void){
+            return m_condition();
+        }
+
+        void _step(void){
+            this->_wait(m_body());
+        }
+
+        Condition m_condition;
+        Body m_body;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Loop for `async_for_each`.
+    ///
+    /// `Range` is a reference type for ranges given as lvalues, otherwise the range is moved in.
+    template<typename Range, typename Body>
+    class ForEachLoop : public AsyncLoop<ForEachLoop<Range, Body>> {
+    public:
+        template<typename RangeArg, typename BodyArg>
+        ForEachLoop(RangeArg&& range, BodyArg&& body):
+            m_range(std::forward<RangeArg>(range)),
+            m_body(std::forward<BodyArg>(body)),
+            m_it(std::begin(m_range))
+        {}
+
+    private:
+        friend class AsyncLoop<ForEachLoop>;
+
+        typedef decltype(std::begin(std::declval<Range&>())) iterator;
+
+        bool _condition(void){
+            return m_it != std::end(m_range);
+        }
+
+        void _step(void){
+            iterator it = m_it++;
+            this->_wait(m_body(*it));
+        }
+
+        Range m_range;
+        Body m_body;
+        iterator m_it;
+    };
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Repeatedly runs an asynchronous body for as long as a condition holds.
+///
+/// The condition is checked before each iteration, and the next iteration only starts once the
+/// future from the body is resolved. A single state is shared by every iteration, so a loop of any
+/// length uses constant memory and stack. The first rejection, or `error::Exception` thrown by
+/// either functor, ends the loop and rejects its future.
+///
+/// @par Example
+/// @code{.cpp}
+///     bool done = false;
+///     lw::event::async_while([&](){ return !done; }, [&](){
+///         return file.read(buffer).then([&](int bytes){ done = bytes == 0; });
+///     }).then([](){
+///         // Read the whole file.
+///     });
+/// @endcode
+///
+/// @tparam Condition A functor returning a `bool`.
+/// @tparam Body      A functor returning a `Future`. The value promised is ignored.
+///
+/// @param condition The functor to check before each iteration.
+/// @param body      The functor to call for each iteration.
+///
+/// @return A future resolved once `condition` returns false.
+template<typename Condition, typename Body>
+Future<> async_while(Condition&& condition, Body&& body){
+    typedef _details::WhileLoop<
+        typename std::decay<Condition>::type,
+        typename std::decay<Body>::type
+    > State;
+
+    _details::IntrusivePtr<State> state(
+        new State(std::forward<Condition>(condition), std::forward<Body>(body))
+    );
+    auto future = state->future();
+    state->run();
+    return future;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Runs an asynchronous body for each element in a range, one at a time.
+///
+/// Each element is passed to the body once the future for the previous element is resolved. Like
+/// `async_while`, memory use does not grow with the length of the range. Ranges given as lvalues
+/// are referenced and must outlive the loop, others are moved into it.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::event::async_for_each(paths, [&](const std::string& path){
+///         return lw::io::open(loop, path).then([](std::shared_ptr<lw::io::File>&& file){
+///             // ...
+///         });
+///     });
+/// @endcode
+///
+/// @tparam Range A type usable with `std::begin` and `std::end`.
+/// @tparam Body  A functor taking an element and returning a `Future`.
+///
+/// @param range The elements to iterate over.
+/// @param body  The functor to call for each element.
+///
+/// @return A future resolved once every element has been visited.
+template<typename Range, typename Body>
+Future<> async_for_each(Range&& range, Body&& body){
+    typedef _details::ForEachLoop<
+        typename std::conditional<
+            std::is_lvalue_reference<Range>::value,
+            Range,
+            typename std::decay<Range>::type
+        >::type,
+        typename std::decay<Body>::type
+    > State;
+
+    _details::IntrusivePtr<State> state(
+        new State(std::forward<Range>(range), std::forward<Body>(body))
+    );
+    auto future = state->future();
+    state->run();
+    return future;
+}
+
+}
+}
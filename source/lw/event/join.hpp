@@ -0,0 +1,585 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lw/error.hpp"
+#include "lw/event/Promise.hpp"
+#include "lw/event/Promise.void.hpp"
+
+#include "lw/event/Promise.impl.hpp"
+
+namespace lw {
+namespace event {
+
+namespace _details {
+    /// @internal
+    /// @brief The type a future contributes to the tuple from `when_all`.
+    template<typename T>
+    struct JoinedValue {
+        typedef T type;
+    };
+
+    template<>
+    struct JoinedValue<void> {
+        typedef std::tuple<> type;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Storage for one value of a tuple join, filled in when its future resolves.
+    ///
+    /// The values arrive in any order, so each is constructed in place rather than assigned over a
+    /// default constructed one. The promised types need only be move constructible.
+    template<typename T>
+    class JoinSlot {
+    public:
+        JoinSlot(void):
+            m_filled(false)
+        {}
+
+        JoinSlot(const JoinSlot&) = delete;
+        JoinSlot& operator=(const JoinSlot&) = delete;
+
+        ~JoinSlot(void){
+            if (m_filled) {
+                m_value.~T();
+            }
+        }
+
+        void fill(T&& value){
+            new (&m_value) T(std::move(value));
+            m_filled = true;
+        }
+
+        T&& take(void){
+            return std::move(m_value);
+        }
+
+    private:
+        union {
+            T m_value;
+        };
+        bool m_filled;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Determines if every type given is `void`.
+    template<typename... Ts>
+    struct AllVoid : public std::true_type {};
+
+    template<typename T, typename... Ts>
+    struct AllVoid<T, Ts...> :
+        public std::integral_constant<bool, std::is_void<T>::value && AllVoid<Ts...>::value>
+    {};
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The promised type of `when_all` over futures for `Ts...`.
+    template<typename... Ts>
+    struct WhenAllResult {
+        typedef typename std::conditional<
+            AllVoid<Ts...>::value,
+            void,
+            std::tuple<typename JoinedValue<Ts>::type...>
+        >::type type;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The promised type of `when_all` over a range of futures for `T`.
+    template<typename T>
+    struct WhenAllRangeResult {
+        typedef std::vector<T> type;
+    };
+
+    template<>
+    struct WhenAllRangeResult<void> {
+        typedef void type;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The promised type of `when_any` and `race`: the index of the winner and its value.
+    template<typename T>
+    struct WhenAnyResult {
+        typedef std::pair<std::size_t, T> type;
+    };
+
+    template<>
+    struct WhenAnyResult<void> {
+        typedef std::size_t type;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The promised type of futures in a range.
+    template<typename Iterator>
+    struct RangeFutureType {
+        typedef typename std::iterator_traits<Iterator>::value_type::result_type type;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief The single block of state shared by every future in a join.
+    ///
+    /// Joins come from the same thread-local pools as promise state, and each joined future holds
+    /// it through a continuation stored inline in its own shared state. Joining N futures therefore
+    /// needs no allocation beyond the joined result itself.
+    ///
+    /// @tparam Derived The concrete join type.
+    /// @tparam Result  The type promised by the join.
+    template<typename Derived, typename Result>
+    class JoinState : public RefCounted<Derived> {
+    public:
+        typedef Result result_type; ///< The type promised by the join.
+
+        static void* operator new(std::size_t){
+            return FreeList<Derived>::allocate();
+        }
+
+        static void operator delete(void* ptr){
+            FreeList<Derived>::deallocate(ptr);
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        /// @param count The number of outcomes to count down from.
+        explicit JoinState(const std::size_t count):
+            m_remaining(count),
+            m_finished(false)
+        {}
+
+        // -------------------------------------------------------------------------------------- //
+
+        Future<Result> future(void){
+            return m_promise.future();
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+    protected:
+        /// @brief Claims the right to finish the join.
+        ///
+        /// @return True for exactly one caller.
+        bool _claim(void){
+            return !m_finished.exchange(true, std::memory_order_acq_rel);
+        }
+
+        /// @brief Counts down one outcome.
+        ///
+        /// @return True if that was the last outcome being waited for.
+        bool _count_down(void){
+            return m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        // -------------------------------------------------------------------------------------- //
+
+        std::atomic<std::size_t> m_remaining;   ///< Outcomes left before the join can finish.
+        std::atomic_bool m_finished;            ///< Flag indicating the join has been settled.
+        Promise<Result> m_promise;              ///< The promise for the joined result.
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Join for `when_all` over a fixed set of futures, collected into a tuple.
+    template<typename... Ts>
+    class AllTupleJoin :
+        public JoinState<AllTupleJoin<Ts...>, typename WhenAllResult<Ts...>::type>
+    {
+    public:
+        AllTupleJoin(void):
+            AllTupleJoin::JoinState(sizeof...(Ts))
+        {}
+
+        template<std::size_t I, typename Value>
+        void settle(Value* value, const error::Error* err){
+            if (err) {
+                if (this->_claim()) {
+                    this->m_promise.reject(*err);
+                }
+                return;
+            }
+
+            _store<I>(value);
+            if (this->_count_down() && this->_claim()) {
+                _finish(AllVoid<Ts...>());
+            }
+        }
+
+    private:
+        template<std::size_t I, typename Value>
+        void _store(Value* value){
+            std::get<I>(m_results).fill(std::move(*value));
+        }
+
+        template<std::size_t I>
+        void _store(Nothing*){
+            std::get<I>(m_results).fill(std::tuple<>());
+        }
+
+        void _finish(std::false_type){
+            _resolve(std::index_sequence_for<Ts...>());
+        }
+
+        void _finish(std::true_type){
+            this->m_promise.resolve();
+        }
+
+        template<std::size_t... Is>
+        void _resolve(std::index_sequence<Is...>){
+            this->m_promise.resolve(
+                typename WhenAllResult<Ts...>::type(std::get<Is>(m_results).take()...)
+            );
+        }
+
+        std::tuple<JoinSlot<typename JoinedValue<Ts>::type>...> m_results;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Join for `when_all` over a range of futures, collected into a vector.
+    template<typename T>
+    class AllRangeJoin : public JoinState<AllRangeJoin<T>, std::vector<T>> {
+    public:
+        explicit AllRangeJoin(const std::size_t count):
+            AllRangeJoin::JoinState(count),
+            m_results(count)
+        {}
+
+        void settle(const std::size_t index, T* value, const error::Error* err){
+            if (err) {
+                if (this->_claim()) {
+                    this->m_promise.reject(*err);
+                }
+                return;
+            }
+
+            m_results[index] = std::move(*value);
+            if (this->_count_down() && this->_claim()) {
+                this->m_promise.resolve(std::move(m_results));
+            }
+        }
+
+    private:
+        std::vector<T> m_results;
+    };
+
+    template<>
+    class AllRangeJoin<void> : public JoinState<AllRangeJoin<void>, void> {
+    public:
+        explicit AllRangeJoin(const std::size_t count):
+            AllRangeJoin::JoinState(count)
+        {}
+
+        void settle(const std::size_t, Nothing*, const error::Error* err){
+            if (err) {
+                if (_claim()) {
+                    m_promise.reject(*err);
+                }
+            }
+            else if (_count_down() && _claim()) {
+                m_promise.resolve();
+            }
+        }
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Join for `when_any` and `race`.
+    ///
+    /// @tparam T    The promised type of the joined futures.
+    /// @tparam Race If true the first outcome wins, otherwise the first resolution wins and the
+    ///              join is only rejected once every future has been rejected.
+    template<typename T, bool Race>
+    class AnyJoin : public JoinState<AnyJoin<T, Race>, typename WhenAnyResult<T>::type> {
+    public:
+        typedef typename StoredValue<T>::type value_type;
+
+        explicit AnyJoin(const std::size_t count):
+            AnyJoin::JoinState(count)
+        {}
+
+        void settle(const std::size_t index, value_type* value, const error::Error* err){
+            if (value) {
+                if (this->_claim()) {
+                    _resolve(index, value);
+                }
+            }
+            else if ((Race || this->_count_down()) && this->_claim()) {
+                this->m_promise.reject(*err);
+            }
+        }
+
+    private:
+        template<typename Value>
+        void _resolve(const std::size_t index, Value* value){
+            this->m_promise.resolve(std::make_pair(index, std::move(*value)));
+        }
+
+        void _resolve(const std::size_t index, Nothing*){
+            this->m_promise.resolve(index);
+        }
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Continuation passing a future's outcome to a join along with its position.
+    template<typename Join, typename T>
+    struct JoinContinuation {
+        typedef typename StoredValue<T>::type value_type;
+
+        JoinContinuation(const IntrusivePtr<Join>& join, const std::size_t index):
+            join(join),
+            index(index)
+        {}
+
+        void operator()(value_type* value, const error::Error* err){
+            join->settle(index, value, err);
+        }
+
+        IntrusivePtr<Join> join;
+        std::size_t index;
+    };
+
+    /// @internal
+    /// @brief Continuation passing a future's outcome to a tuple join.
+    template<typename Join, std::size_t I, typename T>
+    struct TupleJoinContinuation {
+        typedef typename StoredValue<T>::type value_type;
+
+        explicit TupleJoinContinuation(const IntrusivePtr<Join>& join):
+            join(join)
+        {}
+
+        void operator()(value_type* value, const error::Error* err){
+            join->template settle<I>(value, err);
+        }
+
+        IntrusivePtr<Join> join;
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Attaches each of the futures to a tuple join.
+    template<typename Join, std::size_t... Is, typename... Ts>
+    void join_tuple(
+        const IntrusivePtr<Join>& join,
+        std::index_sequence<Is...>,
+        Future<Ts>&... futures
+    ){
+        int expand[] = {0, (
+            FutureAccess::state(futures).template then<TupleJoinContinuation<Join, Is, Ts>>(join),
+            0
+        )...};
+        (void)expand;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Attaches each future in the range to a join, creating the join sized for the range.
+    template<typename Join, typename Iterator>
+    Future<typename Join::result_type> join_range(Iterator begin, Iterator end){
+        typedef typename RangeFutureType<Iterator>::type value_type;
+
+        const std::size_t count = std::distance(begin, end);
+        IntrusivePtr<Join> join(new Join(count));
+        auto future = join->future();
+        std::size_t index = 0;
+        for (; begin != end; ++begin, ++index) {
+            FutureAccess::state(*begin).template then<JoinContinuation<Join, value_type>>(
+                join,
+                index
+            );
+        }
+        return future;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @internal
+    /// @brief Creates an already resolved future for `when_all` over nothing.
+    template<typename T>
+    Future<T> empty_all(void){
+        Promise<T> promise;
+        promise.resolve(T());
+        return promise.future();
+    }
+
+    template<>
+    inline Future<> empty_all<void>(void){
+        Promise<> promise;
+        promise.resolve();
+        return promise.future();
+    }
+
+    /// @internal
+    /// @brief Creates an already rejected future for `when_any` and `race` over nothing.
+    template<typename T>
+    Future<T> empty_join(void){
+        Promise<T> promise;
+        promise.reject(PromiseError(2, "Cannot wait for the first of no futures."));
+        return promise.future();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Waits for every one of the given futures to be resolved.
+///
+/// The values are collected into a tuple in the same order as the futures. `Future<void>`s
+/// contribute an empty `std::tuple<>`, and if every future is a `Future<void>` the result is also a
+/// `Future<void>`. The first rejection rejects the joined future. Unlike the range overload, the
+/// promised types need only be move constructible.
+///
+/// @par Example
+/// @code{.cpp}
+///     lw::event::when_all(file.read(1024), timeout.start(1s))
+///         .then([](std::tuple<lw::memory::Buffer, std::tuple<>>&& results){
+///             // ...
+///         });
+/// @endcode
+///
+/// @param futures The futures to wait on.
+///
+/// @return A future for all of the values.
+template<typename... Ts>
+Future<typename _details::WhenAllResult<Ts...>::type> when_all(Future<Ts>... futures){
+    typedef _details::AllTupleJoin<Ts...> Join;
+
+    _details::IntrusivePtr<Join> join(new Join());
+    auto future = join->future();
+    _details::join_tuple(join, std::index_sequence_for<Ts...>(), futures...);
+    return future;
+}
+
+inline Future<> when_all(void){
+    return _details::empty_all<void>();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Waits for every future in the range to be resolved.
+///
+/// The values are collected into a vector in the same order as the futures, which requires the
+/// promised type to be default constructible. For a range of `Future<void>`s the result is also a
+/// `Future<void>`. The first rejection rejects the joined future.
+///
+/// @tparam Iterator A forward iterator over `Future`s.
+///
+/// @param begin The first future to wait on.
+/// @param end   The end of the range of futures.
+///
+/// @return A future for all of the values.
+template<
+    typename Iterator,
+    typename std::enable_if<!IsFuture<Iterator>::value>::type* = nullptr
+>
+Future<typename _details::WhenAllRangeResult<
+    typename _details::RangeFutureType<Iterator>::type
+>::type>
+when_all(Iterator begin, Iterator end){
+    typedef typename _details::RangeFutureType<Iterator>::type value_type;
+    typedef typename _details::WhenAllRangeResult<value_type>::type result_type;
+    if (begin == end) {
+        return _details::empty_all<result_type>();
+    }
+    return _details::join_range<_details::AllRangeJoin<value_type>>(begin, end);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Waits for the first of the futures in the range to be resolved.
+///
+/// The joined future is resolved with the index of the first future to resolve along with its
+/// value. For `Future<void>`s only the index is given. Rejections are ignored unless every future
+/// is rejected, in which case the joined future is rejected with the last error.
+///
+/// @tparam Iterator A forward iterator over `Future`s.
+///
+/// @param begin The first future to wait on.
+/// @param end   The end of the range of futures.
+///
+/// @return A future for the first resolved value.
+template<
+    typename Iterator,
+    typename std::enable_if<!IsFuture<Iterator>::value>::type* = nullptr
+>
+Future<typename _details::WhenAnyResult<typename _details::RangeFutureType<Iterator>::type>::type>
+when_any(Iterator begin, Iterator end){
+    typedef typename _details::RangeFutureType<Iterator>::type value_type;
+    typedef typename _details::WhenAnyResult<value_type>::type result_type;
+    if (begin == end) {
+        return _details::empty_join<result_type>();
+    }
+    return _details::join_range<_details::AnyJoin<value_type, false>>(begin, end);
+}
+
+/// @brief Waits for the first of the given futures to be resolved.
+///
+/// @see when_any(Iterator, Iterator)
+template<typename T, typename... Rest>
+Future<typename _details::WhenAnyResult<T>::type> when_any(Future<T> first, Future<Rest>... rest){
+    std::array<Future<T>, 1 + sizeof...(Rest)> futures = {{first, rest...}};
+    return when_any(futures.begin(), futures.end());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/// @brief Waits for the first of the futures in the range to be either resolved or rejected.
+///
+/// The joined future is resolved with the index of the first future to finish along with its
+/// value, or rejected with its error. For `Future<void>`s only the index is given.
+///
+/// @tparam Iterator A forward iterator over `Future`s.
+///
+/// @param begin The first future to wait on.
+/// @param end   The end of the range of futures.
+///
+/// @return A future for the first outcome.
+template<
+    typename Iterator,
+    typename std::enable_if<!IsFuture<Iterator>::value>::type* = nullptr
+>
+Future<typename _details::WhenAnyResult<typename _details::RangeFutureType<Iterator>::type>::type>
+race(Iterator begin, Iterator end){
+    typedef typename _details::RangeFutureType<Iterator>::type value_type;
+    typedef typename _details::WhenAnyResult<value_type>::type result_type;
+    if (begin == end) {
+        return _details::empty_join<result_type>();
+    }
+    return _details::join_range<_details::AnyJoin<value_type, true>>(begin, end);
+}
+
+/// @brief Waits for the first of the given futures to be either resolved or rejected.
+///
+/// @see race(Iterator, Iterator)
+template<typename T, typename... Rest>
+Future<typename _details::WhenAnyResult<T>::type> race(Future<T> first, Future<Rest>... rest){
+    std::array<Future<T>, 1 + sizeof...(Rest)> futures = {{first, rest...}};
+    return race(futures.begin(), futures.end());
+}
+
+}
+}
@@ -1,15 +1,14 @@
 #pragma once
 
-#include <chrono>
+#include <type_traits>
+#include <utility>
 
 #include "lw/Application.hpp"
 #include "lw/event/Loop.hpp"
 #include "lw/event/Promise.hpp"
 #include "lw/event/Promise.void.hpp"
-#include "lw/event/Timeout.hpp"
 
 #include "lw/event/Promise.impl.hpp"
-#include "lw/event/Timeout.impl.hpp"
 
 namespace lw {
 namespace event {
@@ -17,7 +16,7 @@ namespace event {
 /// @brief Creates a promise that is immediately resolved with the given value.
 ///
 /// In order to guarantee that the calling function returns before the promise is resolved, the
-/// resolution happens asynchronously on the event loop provided.
+/// resolution is deferred to the next iteration of the event loop provided.
 ///
 /// @tparam T The type that we're resolving with.
 ///
@@ -26,12 +25,22 @@ namespace event {
 ///
 /// @return A promise for the given value.
 template<typename T>
-Future<T> resolve(Loop& loop, T&& t){
-    return wait(loop, std::chrono::seconds(0)).then([t = std::forward<T>(t)](){ return t; });
+Future<typename std::decay<T>::type> resolve(Loop& loop, T&& t){
+    Promise<typename std::decay<T>::type> promise;
+    auto future = promise.future();
+    loop.defer([promise = std::move(promise), value = std::forward<T>(t)]() mutable {
+        promise.resolve(std::move(value));
+    });
+    return future;
 }
 
 inline Future<> resolve(Loop& loop){
-    return wait(loop, std::chrono::seconds(0));
+    Promise<> promise;
+    auto future = promise.future();
+    loop.defer([promise = std::move(promise)]() mutable {
+        promise.resolve();
+    });
+    return future;
 }
 
 // ---------------------------------------------------------------------------------------------- //
@@ -47,12 +56,12 @@ inline Future<> resolve(Loop& loop){
 ///
 /// @return A promise for the given value.
 template<typename T>
-Future<T> resolve(T&& t){
+Future<typename std::decay<T>::type> resolve(T&& t){
     return resolve(Application::instance(), std::forward<T>(t));
 }
 
 inline Future<> resolve(){
-    return wait(Application::instance(), std::chrono::seconds(0));
+    return resolve(static_cast<Loop&>(Application::instance()));
 }
 
 // ---------------------------------------------------------------------------------------------- //
@@ -60,7 +69,7 @@ inline Future<> resolve(){
 /// @brief Creates a promise that is immediately rejected with the given error.
 ///
 /// In order to guarantee that the calling function returns before the promise is rejected, the
-/// rejection happens asynchronously on the event loop provided.
+/// rejection is deferred to the next iteration of the event loop provided.
 ///
 /// @tparam T The type that should be promised.
 ///
@@ -69,12 +78,17 @@ inline Future<> resolve(){
 ///
 /// @return A promise for the given value that will be rejected.
 template<typename T>
-Future<T> reject(Loop& loop, const error::Exception& err){
-    return wait(loop, std::chrono::seconds(0)).then([err]() -> T { throw err; });
+Future<T> reject(Loop& loop, const error::Error& err){
+    Promise<T> promise;
+    auto future = promise.future();
+    loop.defer([promise = std::move(promise), err]() mutable {
+        promise.reject(err);
+    });
+    return future;
 }
 
-inline Future<> reject(Loop& loop, const error::Exception& err){
-    return wait(loop, std::chrono::seconds(0)).then([err](){ throw err; });
+inline Future<> reject(Loop& loop, const error::Error& err){
+    return reject<void>(loop, err);
 }
 
 // ---------------------------------------------------------------------------------------------- //
@@ -90,11 +104,11 @@ inline Future<> reject(Loop& loop, const error::Exception& err){
 ///
 /// @return A promise for the given value that will be rejected.
 template<typename T>
-Future<T> reject(const error::Exception& err){
+Future<T> reject(const error::Error& err){
     return reject<T>(Application::instance(), err);
 }
 
-inline Future<> reject(const error::Exception& err){
+inline Future<> reject(const error::Error& err){
     return reject(Application::instance(), err);
 }
 
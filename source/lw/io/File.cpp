@@ -1,5 +1,4 @@
 
-#include <cstdlib>
 #include <cstring>
 #include <uv.h>
 
@@ -8,21 +7,19 @@
 namespace lw {
 namespace io {
 
-inline FileError _wrap_uv_error( int err_code ){
-    return FileError(
-        err_code,
-        (std::string)uv_err_name( err_code ) + ": " + uv_strerror( err_code )
-    );
+inline error::Error _wrap_uv_error( int err_code ){
+    return error::Error( err_code, error::uv_category< FileError >() );
 }
 
 // -------------------------------------------------------------------------- //
 
 File::File( event::Loop& loop ):
     m_loop( loop ),
-    m_handle( (uv_fs_s*)std::malloc( sizeof( uv_fs_s ) ) ),
+    m_handle( event::HandlePool::allocate< uv_fs_s >() ),
     m_promise( nullptr ),
     m_file_descriptor( -1 ),
-    m_uv_buffer( (uv_buf_t*)std::malloc( sizeof( uv_buf_t ) ) )
+    m_uv_buffer( event::HandlePool::allocate< uv_buf_t >() ),
+    m_cancelled( false )
 {
     m_handle->data = (void*)this;
 }
@@ -36,8 +33,8 @@ File::~File( void ){
 
     uv_fs_req_cleanup( m_handle );
 
-    std::free( m_uv_buffer );
-    std::free( m_handle );
+    event::HandlePool::deallocate( m_uv_buffer );
+    event::HandlePool::deallocate( m_handle );
 }
 
 // -------------------------------------------------------------------------- //
@@ -113,7 +110,10 @@ void File::_close_cb( uv_fs_s* handle ){
 
 // -------------------------------------------------------------------------- //
 
-event::Future< int > File::read( memory::Buffer& data ){
+event::Future< int > File::read(
+    memory::Buffer& data,
+    const event::CancellationToken& token
+){
     *m_uv_buffer = uv_buf_init( (char*)data.data(), data.size() );
 
     uv_fs_read(
@@ -127,7 +127,9 @@ event::Future< int > File::read( memory::Buffer& data ){
     );
 
     auto handlePtr = m_handle;
-    return _reset_promise()
+    auto future = _reset_promise();
+    _bind_cancellation( token );
+    return future
         .then< int >([ handlePtr ]( event::Promise< int >&& promise ){
             promise.resolve( handlePtr->result );
         })
@@ -136,9 +138,12 @@ event::Future< int > File::read( memory::Buffer& data ){
 
 // -------------------------------------------------------------------------- //
 
-event::Future< memory::Buffer > File::read( const std::size_t bytes ){
+event::Future< memory::Buffer > File::read(
+    const std::size_t bytes,
+    const event::CancellationToken& token
+){
     auto dataPtr = std::make_shared< memory::Buffer >( bytes );
-    return read( *dataPtr )
+    return read( *dataPtr, token )
         .then([ dataPtr ]( int size ) mutable {
             return memory::Buffer( std::move( *dataPtr ), size );
         })
@@ -150,6 +155,9 @@ event::Future< memory::Buffer > File::read( const std::size_t bytes ){
 void File::_read_cb( uv_fs_s* handle ){
     int result = handle->result;
     File* file = (File*)handle->data;
+    if( file->_reject_cancelled( result ) ){
+        return;
+    }
     if( result < 0 ){
         file->m_promise->reject( _wrap_uv_error( result ) );
     }
@@ -160,7 +168,10 @@ void File::_read_cb( uv_fs_s* handle ){
 
 // -------------------------------------------------------------------------- //
 
-event::Future<> File::write( const memory::Buffer& data ){
+event::Future<> File::write(
+    const memory::Buffer& data,
+    const event::CancellationToken& token
+){
     *m_uv_buffer = uv_buf_init( (char*)data.data(), data.size() );
 
     uv_fs_write(
@@ -173,7 +184,9 @@ event::Future<> File::write( const memory::Buffer& data ){
         &File::_write_cb
     );
 
-    return _reset_promise();
+    auto future = _reset_promise();
+    _bind_cancellation( token );
+    return future;
 }
 
 // -------------------------------------------------------------------------- //
@@ -181,6 +194,9 @@ event::Future<> File::write( const memory::Buffer& data ){
 void File::_write_cb( uv_fs_s* handle ){
     int result = handle->result;
     File* file = (File*)handle->data;
+    if( file->_reject_cancelled( result ) ){
+        return;
+    }
     if( result < 0 ){
         file->m_promise->reject( _wrap_uv_error( result ) );
     }
@@ -198,6 +214,33 @@ event::Future<> File::_reset_promise( void ){
 
 // -------------------------------------------------------------------------- //
 
+void File::_bind_cancellation( const event::CancellationToken& token ){
+    m_cancelled = false;
+    m_cancellation = token.on_cancel([ this ](){
+        // Requests still queued are pulled from the threadpool and finish with
+        // `UV_ECANCELED`. Ones already running can't be stopped, so their
+        // result is thrown away instead.
+        m_cancelled = true;
+        uv_cancel( (uv_req_t*)m_handle );
+    });
+}
+
+// -------------------------------------------------------------------------- //
+
+bool File::_reject_cancelled( int result ){
+    m_cancellation.reset();
+    if( result != UV_ECANCELED && !m_cancelled ){
+        return false;
+    }
+    m_cancelled = false;
+    m_promise->reject(
+        event::CancelledError( 1, "File operation cancelled." )
+    );
+    return true;
+}
+
+// -------------------------------------------------------------------------- //
+
 event::Future< std::shared_ptr< File > > open(
     event::Loop& loop,
     const std::string& path,
@@ -59,10 +59,19 @@ public:
     /// the lifetime of the given buffer exceeds that of the this function's
     /// execution.
     ///
-    /// @param data The buffer to read into.
+    /// If the token is cancelled while the read is still queued it is removed
+    /// from the threadpool. Reads which have already started run to completion
+    /// but their result is discarded. Either way the future is rejected with
+    /// an `event::CancelledError`.
+    ///
+    /// @param data     The buffer to read into.
+    /// @param token    A token to cancel the read with.
     ///
     /// @return A future integer conaining the number of bytes read.
-    event::Future< int > read( memory::Buffer& data );
+    event::Future< int > read(
+        memory::Buffer& data,
+        const event::CancellationToken& token = event::CancellationToken()
+    );
 
     // ---------------------------------------------------------------------- //
 
@@ -72,18 +81,29 @@ public:
     /// data, thus `buffer.size()` will tell you how much was read.
     ///
     /// @param bytes The maximum number of bytes to read.
+    /// @param token A token to cancel the read with.
     ///
     /// @return A future buffer containing the read data.
-    event::Future< memory::Buffer > read( const std::size_t bytes );
+    event::Future< memory::Buffer > read(
+        const std::size_t bytes,
+        const event::CancellationToken& token = event::CancellationToken()
+    );
 
     // ---------------------------------------------------------------------- //
 
     /// @brief Asynchronously writes data to the file.
     ///
-    /// @param data The data to write.
+    /// Cancellation behaves the same as for `File::read`, so a cancelled write
+    /// may or may not have reached the file.
+    ///
+    /// @param data     The data to write.
+    /// @param token    A token to cancel the write with.
     ///
     /// @return A promise to have the data written.
-    event::Future<> write( const memory::Buffer& data );
+    event::Future<> write(
+        const memory::Buffer& data,
+        const event::CancellationToken& token = event::CancellationToken()
+    );
 
     // ---------------------------------------------------------------------- //
 
@@ -122,11 +142,29 @@ private:
 
     // ---------------------------------------------------------------------- //
 
+    /// @brief Cancels the active request when the token is cancelled.
+    ///
+    /// @param token The token to watch.
+    void _bind_cancellation( const event::CancellationToken& token );
+
+    // ---------------------------------------------------------------------- //
+
+    /// @brief Rejects the promise if the finished request was cancelled.
+    ///
+    /// @param result The result of the request.
+    ///
+    /// @return True if the promise was rejected for cancellation.
+    bool _reject_cancelled( int result );
+
+    // ---------------------------------------------------------------------- //
+
     event::Loop& m_loop;
     uv_fs_s* m_handle;
     std::unique_ptr< event::Promise<> > m_promise;
     int m_file_descriptor;
     uv_buf_t* m_uv_buffer;
+    event::CancellationRegistration m_cancellation;
+    bool m_cancelled;
 };
 
 // -------------------------------------------------------------------------- //
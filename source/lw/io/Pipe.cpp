@@ -1,5 +1,4 @@
 
-#include <cstdlib>
 #include <uv.h>
 
 #include "lw/error.hpp"
@@ -49,8 +48,8 @@ event::Future<> Pipe::connect(const std::string& name){
 
     // Set up the connection request.
     m_connect_req = std::shared_ptr<uv_connect_t>(
-        (uv_connect_t*)std::malloc(sizeof(uv_connect_t)),
-        &std::free
+        event::HandlePool::allocate<uv_connect_t>(),
+        &event::HandlePool::deallocate<uv_connect_t>
     );
     m_connect_req->data = (void*)this;
 
@@ -63,7 +62,9 @@ event::Future<> Pipe::connect(const std::string& name){
         [](uv_connect_t* req, int status){
             Pipe& pipe = *(Pipe*)req->data;
             if (status < 0) {
-                pipe.m_connect_promise.reject(LW_UV_ERROR(PipeError, status));
+                pipe.m_connect_promise.reject(
+                    error::Error(status, error::uv_category<PipeError>())
+                );
             }
             else {
                 pipe.m_connect_promise.resolve();
@@ -79,7 +80,7 @@ event::Future<> Pipe::connect(const std::string& name){
 // ---------------------------------------------------------------------------------------------- //
 
 uv_stream_s* Pipe::_make_state(event::Loop& loop, const bool ipc){
-    uv_pipe_t* pipe = (uv_pipe_t*)std::malloc(sizeof(uv_pipe_t));
+    uv_pipe_t* pipe = event::HandlePool::allocate<uv_pipe_t>();
     uv_pipe_init(loop.lowest_layer(), pipe, ipc);
     return (uv_stream_s*)pipe;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "lw/cache.hpp"
 #include "lw/error.hpp"
 #include "lw/event.hpp"
 #include "lw/fs.hpp"
@@ -9,4 +10,5 @@
 #include "lw/trait.hpp"
 
 #include "lw/Application.hpp"
+#include "lw/LoopGroup.hpp"
 #include "lw/Singleton.hpp"
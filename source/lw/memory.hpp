@@ -1,3 +1,4 @@
 #pragma once
 
 #include "lw/memory/Buffer.hpp"
+#include "lw/memory/FreeList.hpp"
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace lw {
+namespace memory {
+
+
+/// @brief A thread-local free list of memory blocks large enough to hold a `T`.
+///
+/// Promise chains and libuv requests are created and destroyed at a very high rate, recycling the
+/// blocks keeps each of them from making a round trip through the global allocator. An event loop
+/// only ever runs on a single thread, so each loop effectively gets a private pool without any
+/// locking.
+///
+/// Blocks may be returned on a different thread from the one they were taken on, they simply join
+/// that thread's list instead.
+///
+/// @tparam T The type the blocks will be used for.
+template<typename T>
+class FreeList {
+public:
+    /// @brief The most blocks a single thread will keep for reuse.
+    static constexpr std::size_t max_size = 1024;
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Takes a block from the free list, or allocates a new one if the list is empty.
+    static void* allocate(void){
+        _List& list = s_list;
+        if (list.head) {
+            _Node* node = list.head;
+            list.head = node->next;
+            --list.size;
+            return node;
+        }
+        _Drain::ensure();
+        return _new_block();
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+    /// @brief Returns the block to the free list, or releases it if the list is full.
+    ///
+    /// @param ptr A block previously returned by `FreeList::allocate`.
+    static void deallocate(void* ptr){
+        _List& list = s_list;
+        if (list.closed || list.size >= max_size) {
+            _delete_block(ptr);
+            return;
+        }
+        if (!list.head) {
+            _Drain::ensure();
+        }
+        _Node* node = static_cast<_Node*>(ptr);
+        node->next = list.head;
+        list.head = node;
+        ++list.size;
+    }
+
+    // ------------------------------------------------------------------------------------------ //
+
+private:
+    struct _Node {
+        _Node* next;
+    };
+
+    union _Block {
+        _Node node;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+    };
+
+#ifdef __cpp_aligned_new
+    /// @brief Allocates a block, asking for the alignment of over-aligned types.
+    static void* _new_block(void){
+        if (alignof(_Block) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(sizeof(_Block), std::align_val_t(alignof(_Block)));
+        }
+        return ::operator new(sizeof(_Block));
+    }
+
+    /// @brief Releases a block from `_new_block`.
+    static void _delete_block(void* ptr){
+        if (alignof(_Block) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(ptr, std::align_val_t(alignof(_Block)));
+            return;
+        }
+        ::operator delete(ptr);
+    }
+#else
+    static_assert(
+        alignof(_Block) <= alignof(std::max_align_t),
+        "Pooling over-aligned types needs C++17 aligned allocation."
+    );
+
+    /// @brief Allocates a block.
+    static void* _new_block(void){
+        return ::operator new(sizeof(_Block));
+    }
+
+    /// @brief Releases a block from `_new_block`.
+    static void _delete_block(void* ptr){
+        ::operator delete(ptr);
+    }
+#endif
+
+    /// @brief The list itself is trivially destructible so it stays usable during thread teardown.
+    struct _List {
+        _Node* head;
+        std::size_t size;
+        bool closed;
+    };
+
+    /// @brief Releases the cached blocks when the thread exits.
+    struct _Drain {
+        static void ensure(void){
+            static thread_local _Drain drain;
+            (void)drain;
+        }
+
+        ~_Drain(void){
+            _List& list = s_list;
+            list.closed = true;
+            while (list.head) {
+                _Node* node = list.head;
+                list.head = node->next;
+                _delete_block(node);
+            }
+            list.size = 0;
+        }
+    };
+
+    // ------------------------------------------------------------------------------------------ //
+
+    static thread_local _List s_list;
+};
+
+template<typename T>
+thread_local typename FreeList<T>::_List FreeList<T>::s_list = {nullptr, 0, false};
+
+}
+}
@@ -0,0 +1,159 @@
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "lw/LoopGroup.hpp"
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct LoopGroupTests : public testing::Test {
+    LoopGroup::Options options(void){
+        return LoopGroup::Options().threads(4);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopGroupTests, RunsOnEachThread){
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> calls(0);
+    {
+        LoopGroup group(options());
+        EXPECT_EQ(4u, group.size());
+        for (int i = 0; i < 8; ++i) {
+            group.post([&](){
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+                ++calls;
+            });
+        }
+    }
+
+    // Round robin places two tasks on each thread, and the destructor waits for them all.
+    EXPECT_EQ(8, calls.load());
+    EXPECT_EQ(4u, threads.size());
+    EXPECT_EQ(0u, threads.count(std::this_thread::get_id()));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopGroupTests, ThreadApplication){
+    Application main_application;
+    LoopGroup group(options());
+
+    std::atomic<int> matched(0);
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        Application* expected = &group.application(i);
+        group.post_to(i, [&, expected](){
+            if (&Application::instance() == expected && expected != &main_application) {
+                ++matched;
+            }
+        });
+    }
+    group.stop();
+
+    EXPECT_EQ(4, matched.load());
+    EXPECT_EQ(&main_application, &Application::instance());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopGroupTests, LeastLoaded){
+    LoopGroup group(options().placement(LoopGroup::Placement::LEAST_LOADED));
+
+    // Hold the first loop up so work piles up on it, then check new work goes elsewhere.
+    std::atomic<bool> release(false);
+    group.post_to(0, [&](){
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    group.post_to(0, [](){});
+    EXPECT_NE(0u, group.choose(LoopGroup::Placement::LEAST_LOADED));
+
+    std::atomic<int> calls(0);
+    for (int i = 0; i < 6; ++i) {
+        group.post([&](){ ++calls; });
+    }
+    release = true;
+    group.stop();
+    EXPECT_EQ(6, calls.load());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopGroupTests, Promises){
+    LoopGroup group(options());
+
+    // Promises bound to a worker's loop may be resolved from any thread.
+    std::atomic<int> result(0);
+    std::atomic<bool> resolved_on_worker(false);
+    std::thread resolver;
+    group.post_to(1, [&](){
+        event::Promise<int> promise(Application::instance());
+        promise.future().then([&, thread = std::this_thread::get_id()](int value){
+            resolved_on_worker = std::this_thread::get_id() == thread;
+            result = value;
+        });
+
+        resolver = std::thread([promise = std::move(promise)]() mutable {
+            promise.resolve(42);
+        });
+    });
+    group.stop();
+    resolver.join();
+
+    EXPECT_EQ(42, result.load());
+    EXPECT_TRUE(resolved_on_worker.load());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopGroupTests, PostAfterStop){
+    LoopGroup group(options());
+    group.stop();
+    group.stop();
+
+    EXPECT_THROW(group.post([](){}), LoopGroupError);
+    EXPECT_THROW(group.post_to(0, [](){}), LoopGroupError);
+    EXPECT_THROW(group.application(0), LoopGroupError);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopGroupTests, PostDuringStop){
+    LoopGroup group(options());
+    std::atomic<bool> stopped(false);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 4; ++i) {
+        producers.emplace_back([&](){
+            // Every post either goes through or is turned away, none may use a finished loop.
+            try {
+                while (true) {
+                    group.post([](){});
+                }
+            }
+            catch (const LoopGroupError&) {
+                stopped = true;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    group.stop();
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(stopped);
+}
+
+}
+}
@@ -0,0 +1,118 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "lw/cache.hpp"
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct AsyncCacheTests : public testing::Test {
+    event::Loop loop;
+    int loads = 0;
+
+    /// Makes a loader which counts its calls and resolves after a short wait.
+    auto loader(const std::string& value){
+        return [this, value](){
+            ++loads;
+            return event::wait(loop, 1ms).then([value](){ return value; });
+        };
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(AsyncCacheTests, Coalescing){
+    cache::AsyncCache<std::string, std::string> cache(loop, 16, 1s);
+    int received = 0;
+    for (int i = 0; i < 10; ++i) {
+        cache.get("key", loader("value")).then([&](std::string&& value){
+            EXPECT_EQ("value", value);
+            ++received;
+        });
+    }
+    EXPECT_EQ(1, loads);
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_FALSE(cache.contains("key"));
+
+    loop.run();
+    EXPECT_EQ(10, received);
+    EXPECT_TRUE(cache.contains("key"));
+
+    // Cached now, so nothing is loaded and the value is ready straight away.
+    bool resolved = false;
+    cache.get("key", loader("other")).then([&](std::string&& value){
+        EXPECT_EQ("value", value);
+        resolved = true;
+    });
+    EXPECT_TRUE(resolved);
+    EXPECT_EQ(1, loads);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(AsyncCacheTests, LeastRecentlyUsed){
+    cache::AsyncCache<int, std::string> cache(loop, 2, 1s);
+    cache.get(1, loader("one"));
+    cache.get(2, loader("two"));
+    loop.run();
+
+    cache.get(1, loader("one"));
+    cache.get(3, loader("three"));
+    loop.run();
+    EXPECT_EQ(3, loads);
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(AsyncCacheTests, Expiry){
+    cache::AsyncCache<int, std::string> cache(loop, 16, 10ms);
+    cache.get(1, loader("one"));
+    loop.run();
+
+    // The expiry timer does not keep the loop running by itself.
+    EXPECT_TRUE(cache.contains(1));
+    event::wait(loop, 30ms);
+    loop.run();
+    EXPECT_EQ(0u, cache.size());
+
+    cache.get(1, loader("one"));
+    EXPECT_EQ(2, loads);
+    loop.run();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(AsyncCacheTests, FailedLoad){
+    cache::AsyncCache<int, std::string> cache(loop, 16, 1s);
+    int rejected = 0;
+    for (int i = 0; i < 3; ++i) {
+        cache.get(1, [&](){
+            ++loads;
+            return event::wait(loop, 1ms).then([]() -> std::string {
+                throw error::Exception(5, "Load failed.");
+            });
+        }).then([](std::string&&){
+            FAIL() << "Entered resolve handler for failed load.";
+        }, [&](const error::Exception& err){
+            EXPECT_EQ(5, err.error_code());
+            ++rejected;
+        });
+    }
+
+    loop.run();
+    EXPECT_EQ(1, loads);
+    EXPECT_EQ(3, rejected);
+    EXPECT_EQ(0u, cache.size());
+}
+
+}
+}
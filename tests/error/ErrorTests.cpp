@@ -0,0 +1,141 @@
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <uv.h>
+#include <vector>
+
+#include "lw/error.hpp"
+#include "lw/event.hpp"
+#include "lw/io.hpp"
+
+namespace lw {
+namespace tests {
+
+struct ErrorTests : public testing::Test {};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, UvMessage){
+    error::Error err(UV_ENOENT, error::uv_category<io::FileError>());
+    EXPECT_EQ(UV_ENOENT, err.code());
+    EXPECT_EQ(&error::uv_category<io::FileError>(), &err.category());
+    EXPECT_STREQ("uv", err.category().name());
+    EXPECT_EQ(LW_UV_ERROR(io::FileError, UV_ENOENT).what(), err.message());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, ExceptionType){
+    error::Error err(UV_EPIPE, error::uv_category<event::StreamError>());
+    EXPECT_NE(nullptr, dynamic_cast<const event::StreamError*>(&err.exception()));
+    EXPECT_EQ(UV_EPIPE, err.exception().error_code());
+    EXPECT_THROW(err.raise(), event::StreamError);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, FromException){
+    error::Error err = event::TimeoutError(42, "Timed out.");
+    EXPECT_EQ(42, err.code());
+    EXPECT_EQ(&error::exception_category(), &err.category());
+    EXPECT_EQ("Timed out.", err.message());
+    EXPECT_NE(nullptr, dynamic_cast<const event::TimeoutError*>(&err.exception()));
+    EXPECT_THROW(err.raise(), event::TimeoutError);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, ErrorHandler){
+    event::Promise<int> promise;
+    bool rejected = false;
+    promise.future().then([](int){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Error& err){
+        EXPECT_EQ(UV_ECONNRESET, err.code());
+        EXPECT_EQ(&error::uv_category<event::StreamError>(), &err.category());
+        rejected = true;
+    });
+
+    promise.reject(error::Error(UV_ECONNRESET, error::uv_category<event::StreamError>()));
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, ExceptionHandler){
+    event::Promise<> promise;
+    bool rejected = false;
+    promise.future().then([](){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Exception& err){
+        EXPECT_NE(nullptr, dynamic_cast<const event::StreamError*>(&err));
+        EXPECT_EQ(LW_UV_ERROR(event::StreamError, UV_ECONNRESET).what(), std::string(err.what()));
+        rejected = true;
+    });
+
+    promise.reject(error::Error(UV_ECONNRESET, error::uv_category<event::StreamError>()));
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, SharedAcrossThreads){
+    // Every thread sees the one exception made for the error, however they race to make it.
+    const error::Error err(UV_ENOENT, error::uv_category<io::FileError>());
+    std::vector<const error::Exception*> seen(4, nullptr);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([&, i](){ seen[i] = &err.exception(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const error::Exception* exception : seen) {
+        EXPECT_EQ(&err.exception(), exception);
+    }
+    EXPECT_NE(nullptr, dynamic_cast<const io::FileError*>(&err.exception()));
+
+    // Copies make their own.
+    const error::Error copy = err;
+    EXPECT_EQ(err.message(), copy.exception().what());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, CurrentKeepsType){
+    try {
+        throw event::TimeoutError(7, "Timed out.");
+    }
+    catch (const error::Exception&) {
+        const error::Error err = error::Error::current();
+        EXPECT_EQ(7, err.code());
+        EXPECT_EQ("Timed out.", err.message());
+        EXPECT_NE(nullptr, dynamic_cast<const event::TimeoutError*>(&err.exception()));
+        EXPECT_THROW(err.raise(), event::TimeoutError);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ErrorTests, ContinuationKeepsType){
+    // Thrown in a continuation and caught there as a base `Exception`, the error downstream is
+    // still the original type.
+    event::Promise<> promise;
+    bool rejected = false;
+    promise.future().then([](){
+        throw event::TimeoutError(7, "Timed out.");
+    }).then([](){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Error& err){
+        EXPECT_NE(nullptr, dynamic_cast<const event::TimeoutError*>(&err.exception()));
+        EXPECT_THROW(err.raise(), event::TimeoutError);
+        rejected = true;
+    });
+
+    promise.resolve();
+    EXPECT_TRUE(rejected);
+}
+
+}
+}
@@ -0,0 +1,189 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <unistd.h>
+
+#include "lw/event.hpp"
+#include "lw/io.hpp"
+#include "lw/memory.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct CancellationTests : public testing::Test {
+    event::Loop loop;
+    event::CancellationSource source;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, Callbacks){
+    int calls = 0;
+    auto token = source.token();
+    auto first = token.on_cancel([&](){ ++calls; });
+    auto second = token.on_cancel([&](){ calls += 10; });
+    second.reset();
+    EXPECT_FALSE(token.is_cancelled());
+
+    source.cancel();
+    source.cancel();
+    EXPECT_TRUE(token.is_cancelled());
+    EXPECT_EQ(1, calls);
+
+    auto late = token.on_cancel([&](){ calls += 100; });
+    EXPECT_EQ(101, calls);
+
+    event::CancellationToken never;
+    EXPECT_FALSE(never.can_be_cancelled());
+    auto ignored = never.on_cancel([&](){ FAIL() << "Default token was cancelled."; });
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, CallbackDestroysRegistration){
+    int calls = 0;
+    auto token = source.token();
+    std::unique_ptr<event::CancellationRegistration> second;
+    auto first = token.on_cancel([&](){
+        ++calls;
+        second.reset();
+    });
+    second.reset(new event::CancellationRegistration(token.on_cancel([&](){ calls += 10; })));
+    event::CancellationRegistration third;
+    third = token.on_cancel([&](){
+        calls += 100;
+        third.reset(); // Resetting the running callback's own registration.
+    });
+
+    source.cancel();
+    EXPECT_EQ(101, calls);
+    first.reset();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, ThrowingCallback){
+    int calls = 0;
+    auto token = source.token();
+    auto first = token.on_cancel([&](){ ++calls; });
+    auto throwing = token.on_cancel([&](){
+        ++calls;
+        throw error::Exception(3, "Callback error");
+    });
+    auto second_throwing = token.on_cancel([&](){
+        ++calls;
+        throw error::Exception(4, "Second callback error");
+    });
+    auto last = token.on_cancel([&](){ ++calls; });
+
+    try {
+        source.cancel();
+        FAIL() << "Cancel swallowed the callback's error.";
+    }
+    catch (const error::Exception& err) {
+        EXPECT_EQ(3, err.error_code());
+    }
+    EXPECT_EQ(4, calls);
+    EXPECT_TRUE(token.is_cancelled());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, CancellableChain){
+    event::Promise<int> promise;
+    bool rejected = false;
+    event::cancellable(promise.future(), source.token())
+        .then([](int value){ return value * 2; })
+        .then([&](int){
+            FAIL() << "Entered resolve handler for cancelled chain.";
+        }, [&](const error::Exception& err){
+            EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+            rejected = true;
+        });
+
+    source.cancel();
+    EXPECT_TRUE(rejected);
+    promise.resolve(5);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, CancellableFinishesFirst){
+    event::Promise<> promise;
+    bool resolved = false;
+    event::cancellable(promise.future(), source.token()).then([&](){ resolved = true; });
+
+    promise.resolve();
+    EXPECT_TRUE(resolved);
+    source.cancel();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, Timeout){
+    bool rejected = false;
+    auto start = std::chrono::steady_clock::now();
+    event::wait(loop, 10s, source.token()).then([&](){
+        FAIL() << "Entered resolve handler for cancelled timeout.";
+    }, [&](const error::Exception& err){
+        EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+        rejected = true;
+    });
+    event::wait(loop, 5ms).then([&](){ source.cancel(); });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, FileRead){
+    io::File file(loop);
+    bool rejected = false;
+    file.open("/tmp/liblw-cancellationtests-testfile").then([&](){
+        auto read = file.read(1024, source.token());
+        source.cancel();
+        return read;
+    }).then([&](memory::Buffer&&){
+        FAIL() << "Entered resolve handler for cancelled read.";
+    }, [&](const error::Exception& err){
+        EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+        rejected = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CancellationTests, StreamRead){
+    int pipes[2];
+    ASSERT_EQ(0, ::pipe(pipes));
+
+    bool rejected = false;
+    {
+        io::Pipe pipe(loop);
+        pipe.open(pipes[0]);
+        pipe.read([&](const std::shared_ptr<const memory::Buffer>&){
+            FAIL() << "Read data from empty pipe.";
+        }, source.token()).then([&](std::size_t){
+            FAIL() << "Entered resolve handler for cancelled read.";
+        }, [&](const error::Exception& err){
+            EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+            rejected = true;
+        });
+
+        event::wait(loop, 5ms).then([&](){ source.cancel(); });
+        loop.run();
+    }
+    EXPECT_TRUE(rejected);
+    ::close(pipes[1]);
+}
+
+}
+}
@@ -0,0 +1,168 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct CooperativeSchedulerTests : public testing::Test {
+    typedef event::CooperativeScheduler::Progress Progress;
+
+    event::Loop loop;
+
+    /// Keeps the thread busy without giving the loop a chance to run.
+    static void block(const std::chrono::microseconds duration){
+        const auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CooperativeSchedulerTests, TakeTurns){
+    event::CooperativeScheduler scheduler(loop);
+    std::string order;
+    int a = 0;
+    int b = 0;
+    int finished = 0;
+
+    scheduler.schedule([&](){
+        order += 'a';
+        return ++a < 3 ? Progress::MORE : Progress::DONE;
+    }).then([&](){ ++finished; });
+    scheduler.schedule([&](){
+        order += 'b';
+        return ++b < 2 ? Progress::MORE : Progress::DONE;
+    }).then([&](){ ++finished; });
+    EXPECT_EQ(2u, scheduler.size());
+    EXPECT_TRUE(order.empty());
+
+    loop.run();
+    EXPECT_EQ("ababa", order);
+    EXPECT_EQ(2, finished);
+    EXPECT_EQ(0u, scheduler.size());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CooperativeSchedulerTests, Budget){
+    event::CooperativeScheduler scheduler(loop, 2ms);
+    EXPECT_EQ(2ms, scheduler.budget());
+
+    int steps = 0;
+    int timer_steps = -1;
+    scheduler.schedule([&](){
+        block(500us);
+        return ++steps < 40 ? Progress::MORE : Progress::DONE;
+    });
+    event::wait(loop, 5ms).then([&](){ timer_steps = steps; });
+
+    // Each iteration only steps for as long as the budget allows.
+    int iterations = 0;
+    int previous = 0;
+    while (loop.run_once()) {
+        ++iterations;
+        EXPECT_LE(steps - previous, 5);
+        previous = steps;
+    }
+    EXPECT_EQ(40, steps);
+    EXPECT_LE(8, iterations);
+
+    // The timer fired part way through the job.
+    EXPECT_LT(0, timer_steps);
+    EXPECT_GT(40, timer_steps);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CooperativeSchedulerTests, Lanes){
+    event::CooperativeScheduler scheduler(loop, 1ms);
+    int high = 0;
+    int low = 0;
+    scheduler.schedule([&](){
+        ++low;
+        return low < 3 ? Progress::MORE : Progress::DONE;
+    }, event::Priority::LOW);
+    scheduler.schedule([&](){
+        block(200us);
+        return ++high < 20 ? Progress::MORE : Progress::DONE;
+    }, event::Priority::HIGH);
+
+    // The high lane takes the budget, the low lane still gets its one step.
+    EXPECT_TRUE(loop.run_once());
+    EXPECT_LE(2, high);
+    EXPECT_GT(20, high);
+    EXPECT_EQ(1, low);
+
+    loop.run();
+    EXPECT_EQ(20, high);
+    EXPECT_EQ(3, low);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CooperativeSchedulerTests, Rejected){
+    event::CooperativeScheduler scheduler(loop);
+    bool rejected = false;
+
+    scheduler.schedule([]() -> Progress {
+        throw error::Exception(4, "Failed in task.");
+    }).then([](){
+        FAIL() << "Entered resolve handler for failed task.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(4, err.error_code());
+        rejected = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+    EXPECT_EQ(0u, scheduler.size());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CooperativeSchedulerTests, Destroyed){
+    bool cancelled = false;
+    {
+        event::CooperativeScheduler scheduler(loop);
+        scheduler.schedule([](){ return Progress::MORE; }).then([](){
+            FAIL() << "Entered resolve handler for unfinished task.";
+        }, [&](const error::Exception& err){
+            EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+            cancelled = true;
+        });
+    }
+    EXPECT_TRUE(cancelled);
+    EXPECT_FALSE(loop.run_nowait());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CooperativeSchedulerTests, DroppedFutures){
+    // Tasks are fire and forget, so failing or unfinished ones must not raise when nobody listens.
+    bool after = false;
+    {
+        event::CooperativeScheduler scheduler(loop);
+        scheduler.schedule([]() -> Progress {
+            throw error::Exception(4, "Failed in task.");
+        });
+        scheduler.schedule([&](){
+            after = true;
+            return Progress::DONE;
+        });
+        EXPECT_NO_THROW(loop.run());
+        EXPECT_TRUE(after);
+
+        scheduler.schedule([](){ return Progress::MORE; });
+    }
+    EXPECT_FALSE(loop.run_nowait());
+}
+
+}
+}
@@ -0,0 +1,162 @@
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "lw/event.hpp"
+#include "lw/io.hpp"
+
+#ifdef LW_HAS_COROUTINES
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct CoroutineTests : public testing::Test {
+    event::Loop loop;
+    std::string file_name = "/tmp/liblw-coroutinetests-testfile";
+
+    void TearDown(void){
+        std::remove(file_name.c_str());
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+event::Future<int> add_one(event::Future<int> value){
+    int result = co_await value;
+    co_return result + 1;
+}
+
+TEST_F(CoroutineTests, AwaitPending){
+    event::Promise<int> promise;
+    int result = 0;
+    add_one(promise.future()).then([&](int value){ result = value; });
+    EXPECT_EQ(0, result);
+
+    promise.resolve(41);
+    EXPECT_EQ(42, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(CoroutineTests, AwaitReady){
+    event::Promise<int> promise;
+    promise.resolve(1);
+
+    int result = 0;
+    add_one(promise.future()).then([&](int value){ result = value; });
+    EXPECT_EQ(2, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+event::Future<> count_ticks(event::Loop& loop, int& ticks, const int total){
+    while (ticks < total) {
+        co_await event::wait(loop, 1ms);
+        ++ticks;
+    }
+}
+
+TEST_F(CoroutineTests, AwaitTimeouts){
+    int ticks = 0;
+    bool finished = false;
+    count_ticks(loop, ticks, 5).then([&](){ finished = true; });
+    EXPECT_FALSE(finished);
+
+    loop.run();
+    EXPECT_EQ(5, ticks);
+    EXPECT_TRUE(finished);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+event::Future<int> catch_rejection(event::Future<int> value){
+    try {
+        co_await value;
+    }
+    catch (const error::Exception& err) {
+        co_return (int)err.error_code();
+    }
+    co_return 0;
+}
+
+TEST_F(CoroutineTests, RejectionThrows){
+    event::Promise<int> promise;
+    int result = 0;
+    catch_rejection(promise.future()).then([&](int value){ result = value; });
+
+    promise.reject(error::Exception(7, "Test error"));
+    EXPECT_EQ(7, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+event::Future<int> throw_error(void){
+    throw error::Exception(9, "Coroutine error");
+    co_return 0;
+}
+
+TEST_F(CoroutineTests, UncaughtErrorRejects){
+    bool rejected = false;
+    throw_error().then([&](int){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(9, err.error_code());
+        rejected = true;
+    });
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+event::Future<int> throw_foreign(void){
+    throw std::runtime_error("Foreign error");
+    co_return 0;
+}
+
+TEST_F(CoroutineTests, ForeignErrorRejects){
+    bool rejected = false;
+    throw_foreign().then([&](int){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Error& err){
+        EXPECT_NE(nullptr, dynamic_cast<const error::ForeignException*>(&err.exception()));
+        EXPECT_EQ("Foreign error", err.message());
+        EXPECT_THROW(err.raise(), std::runtime_error);
+        rejected = true;
+    });
+    EXPECT_TRUE(rejected);
+
+    // Nobody is waiting on a dropped coroutine, so its error goes nowhere.
+    EXPECT_NO_THROW(throw_foreign());
+    EXPECT_NO_THROW(throw_error());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+event::Future<std::string> write_and_read(event::Loop& loop, const std::string& name){
+    io::File file(loop);
+    co_await file.open(name, std::ios::in | std::ios::out | std::ios::trunc);
+
+    memory::Buffer contents(5);
+    contents.copy(std::string("hello").begin(), std::string("hello").end());
+    co_await file.write(contents);
+    co_await file.close();
+
+    co_await file.open(name, std::ios::in);
+    memory::Buffer read = co_await file.read(1024);
+    co_return std::string((const char*)read.data(), read.size());
+}
+
+TEST_F(CoroutineTests, FileIo){
+    std::string result;
+    write_and_read(loop, file_name).then([&](std::string&& value){ result = value; });
+
+    loop.run();
+    EXPECT_EQ("hello", result);
+}
+
+}
+}
+
+#endif
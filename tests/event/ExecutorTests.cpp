@@ -0,0 +1,209 @@
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct ExecutorTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, Deque){
+    event::_details::WorkStealingDeque<int> deque(2);
+    std::vector<int> values(10);
+    for (int& value : values) {
+        deque.push(&value);
+    }
+    EXPECT_FALSE(deque.empty());
+
+    // Taken newest first, stolen oldest first, growing past the initial capacity.
+    EXPECT_EQ(&values[9], deque.take());
+    EXPECT_EQ(&values[0], deque.steal());
+    EXPECT_EQ(&values[8], deque.take());
+    EXPECT_EQ(&values[1], deque.steal());
+    while (deque.take()) {}
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(nullptr, deque.steal());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, DequeThieves){
+    const int count = 100000;
+    event::_details::WorkStealingDeque<int> deque;
+    std::vector<int> values(count, 0);
+    std::atomic<bool> done(false);
+    std::atomic<int> taken(0);
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; ++i) {
+        thieves.emplace_back([&](){
+            while (!done.load() || !deque.empty()) {
+                if (int* value = deque.steal()) {
+                    ++*value;
+                    ++taken;
+                }
+            }
+        });
+    }
+
+    for (int& value : values) {
+        deque.push(&value);
+        if ((&value - &values[0]) % 3 == 0) {
+            if (int* taken_value = deque.take()) {
+                ++*taken_value;
+                ++taken;
+            }
+        }
+    }
+    while (int* value = deque.take()) {
+        ++*value;
+        ++taken;
+    }
+    done = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    // Every item is handed out exactly once.
+    EXPECT_EQ(count, taken.load());
+    for (int value : values) {
+        EXPECT_EQ(1, value);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, Post){
+    std::atomic<int> calls(0);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    {
+        event::Executor executor(4);
+        EXPECT_EQ(4u, executor.size());
+
+        // Tasks posted from the executor's own threads go on their deques to be stolen.
+        for (int i = 0; i < 16; ++i) {
+            executor.post([&](){
+                for (int j = 0; j < 16; ++j) {
+                    executor.post([&](){
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            threads.insert(std::this_thread::get_id());
+                        }
+                        ++calls;
+                    });
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(256, calls.load());
+    EXPECT_EQ(0u, threads.count(std::this_thread::get_id()));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, Submit){
+    event::Executor executor(2);
+    std::thread::id work_thread;
+    std::thread::id continuation_thread;
+    int result = 0;
+    executor.submit([&](){
+        work_thread = std::this_thread::get_id();
+        return 42;
+    }).then([&](int value){
+        continuation_thread = std::this_thread::get_id();
+        result = value;
+    });
+
+    loop.run();
+    EXPECT_EQ(42, result);
+    EXPECT_NE(std::this_thread::get_id(), work_thread);
+    EXPECT_EQ(std::this_thread::get_id(), continuation_thread);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, ThenOn){
+    event::Executor executor(2);
+    std::thread::id work_thread;
+    std::thread::id continuation_thread;
+    std::size_t length = 0;
+
+    event::wait(loop, std::chrono::milliseconds(1)).then([](){
+        return std::string("hello");
+    }).then_on(executor, [&](std::string&& value){
+        work_thread = std::this_thread::get_id();
+        return value.size();
+    }).then_on(executor, [](std::size_t size){
+        return size * 2;
+    }).then([&](std::size_t size){
+        continuation_thread = std::this_thread::get_id();
+        length = size;
+    });
+
+    loop.run();
+    EXPECT_EQ(10u, length);
+    EXPECT_NE(std::this_thread::get_id(), work_thread);
+    EXPECT_EQ(std::this_thread::get_id(), continuation_thread);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, ThenOnRejected){
+    event::Executor executor(2);
+    bool ran = false;
+    bool rejected = false;
+
+    event::Promise<> promise;
+    promise.future().then_on(executor, [&](){
+        ran = true;
+        throw error::Exception(4, "Failed on executor.");
+    }).then_on(executor, [&](){
+        ran = false;
+    }).then([](){
+        FAIL() << "Entered resolve handler for failed work.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(4, err.error_code());
+        rejected = true;
+    });
+    promise.resolve();
+
+    loop.run();
+    EXPECT_TRUE(ran);
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(ExecutorTests, SubmitForeignException){
+    event::Executor executor(2);
+    bool rejected = false;
+    executor.submit([]() -> int {
+        throw std::runtime_error("Parse failed.");
+    }).then([](int){
+        FAIL() << "Entered resolve handler for failed work.";
+    }, [&](const error::Error& err){
+        EXPECT_EQ("Parse failed.", err.message());
+        EXPECT_THROW(err.raise(), std::runtime_error);
+        rejected = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+}
+
+}
+}
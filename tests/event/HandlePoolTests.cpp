@@ -0,0 +1,65 @@
+
+#include <gtest/gtest.h>
+#include <uv.h>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct HandlePoolTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(HandlePoolTests, Recycle){
+    uv_timer_t* timer = event::HandlePool::allocate<uv_timer_t>();
+    event::HandlePool::deallocate(timer);
+    EXPECT_EQ(timer, event::HandlePool::allocate<uv_timer_t>());
+    event::HandlePool::deallocate(timer);
+
+    // Blocks past the largest size class still come and go through the global allocator.
+    void* large = event::HandlePool::allocate(event::HandlePool::max_size + 1);
+    ASSERT_NE(nullptr, large);
+    event::HandlePool::deallocate(large, event::HandlePool::max_size + 1);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(HandlePoolTests, SizeClasses){
+    static_assert(sizeof(uv_idle_t) == sizeof(uv_check_t), "Idle and check handles differ.");
+
+    // Types of the same size share a pool, whether freed by type or by size.
+    uv_idle_t* idle = event::HandlePool::allocate<uv_idle_t>();
+    event::HandlePool::deallocate(idle, sizeof(uv_idle_t));
+    uv_check_t* check = event::HandlePool::allocate<uv_check_t>();
+    EXPECT_EQ((void*)idle, (void*)check);
+    event::HandlePool::deallocate(check);
+    EXPECT_EQ((void*)check, event::HandlePool::allocate(sizeof(uv_idle_t)));
+    event::HandlePool::deallocate(check);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(HandlePoolTests, CloseReturnsHandle){
+    uv_timer_t* timer = event::HandlePool::allocate<uv_timer_t>();
+    event::HandlePool::deallocate(timer);
+    {
+        event::Timeout timeout(loop);
+    }
+
+    // The timer's block only goes back to the pool once the loop has closed the handle.
+    uv_timer_t* other = event::HandlePool::allocate<uv_timer_t>();
+    EXPECT_NE(timer, other);
+    event::HandlePool::deallocate(other);
+
+    loop.run();
+    EXPECT_EQ(timer, event::HandlePool::allocate<uv_timer_t>());
+    EXPECT_EQ(other, event::HandlePool::allocate<uv_timer_t>());
+    event::HandlePool::deallocate(timer);
+    event::HandlePool::deallocate(other);
+}
+
+}
+}
@@ -0,0 +1,123 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct IterateTests : public testing::Test {
+    event::Loop loop;
+
+    static event::Future<> ready(void){
+        event::Promise<> promise;
+        promise.resolve();
+        return promise.future();
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(IterateTests, WhileReady){
+    const int iterations = 500000;
+    int count = 0;
+    bool resolved = false;
+    event::async_while([&](){ return count < iterations; }, [&](){
+        ++count;
+        return ready();
+    }).then([&](){ resolved = true; });
+
+    EXPECT_TRUE(resolved);
+    EXPECT_EQ(iterations, count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(IterateTests, WhileAsync){
+    int ticks = 0;
+    bool resolved = false;
+    event::async_while([&](){ return ticks < 5; }, [&](){
+        return event::wait(loop, 1ms).then([&](){ ++ticks; });
+    }).then([&](){ resolved = true; });
+
+    EXPECT_EQ(0, ticks);
+    loop.run();
+    EXPECT_TRUE(resolved);
+    EXPECT_EQ(5, ticks);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(IterateTests, WhileRejected){
+    int count = 0;
+    bool rejected = false;
+    event::async_while([&](){ return true; }, [&](){
+        if (++count == 3) {
+            return event::reject(loop, error::Exception(3, "Third iteration."));
+        }
+        return ready();
+    }).then([](){
+        FAIL() << "Entered resolve handler for rejected loop.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(3, err.error_code());
+        rejected = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+    EXPECT_EQ(3, count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(IterateTests, WhileThrows){
+    bool rejected = false;
+    event::async_while([&]() -> bool {
+        throw error::Exception(7, "Condition failed.");
+    }, [&](){
+        return ready();
+    }).then([](){
+        FAIL() << "Entered resolve handler for rejected loop.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(7, err.error_code());
+        rejected = true;
+    });
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(IterateTests, ForEach){
+    std::vector<int> values = {1, 2, 3, 4};
+    std::vector<int> seen;
+    bool resolved = false;
+    event::async_for_each(values, [&](int& value){
+        return event::wait(loop, 1ms).then([&](){ seen.push_back(value * 10); });
+    }).then([&](){ resolved = true; });
+
+    loop.run();
+    EXPECT_TRUE(resolved);
+    EXPECT_EQ((std::vector<int>{10, 20, 30, 40}), seen);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(IterateTests, ForEachTemporary){
+    int sum = 0;
+    bool resolved = false;
+    event::async_for_each(std::vector<int>{1, 2, 3}, [&](int value){
+        sum += value;
+        return event::wait(loop, 1ms);
+    }).then([&](){ resolved = true; });
+
+    loop.run();
+    EXPECT_TRUE(resolved);
+    EXPECT_EQ(6, sum);
+}
+
+}
+}
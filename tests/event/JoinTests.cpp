@@ -0,0 +1,220 @@
+
+#include <gtest/gtest.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct JoinTests : public testing::Test {
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAllTuple){
+    event::Promise<int> first;
+    event::Promise<> second;
+    event::Promise<std::string> third;
+
+    bool resolved = false;
+    event::when_all(first.future(), second.future(), third.future())
+        .then([&](std::tuple<int, std::tuple<>, std::string>&& results){
+            EXPECT_EQ(1, std::get<0>(results));
+            EXPECT_EQ("three", std::get<2>(results));
+            resolved = true;
+        });
+
+    third.resolve("three");
+    first.resolve(1);
+    EXPECT_FALSE(resolved);
+    second.resolve();
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAllNotDefaultConstructible){
+    struct Value {
+        explicit Value(const int value): value(value) {}
+        int value;
+    };
+
+    event::Promise<Value> first;
+    event::Promise<std::string> second;
+
+    bool resolved = false;
+    event::when_all(first.future(), second.future())
+        .then([&](std::tuple<Value, std::string>&& results){
+            EXPECT_EQ(4, std::get<0>(results).value);
+            EXPECT_EQ("two", std::get<1>(results));
+            resolved = true;
+        });
+
+    second.resolve("two");
+    first.resolve(Value(4));
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAllVoid){
+    event::Promise<> first;
+    event::Promise<> second;
+    first.resolve();
+
+    bool resolved = false;
+    event::when_all(first.future(), second.future()).then([&](){ resolved = true; });
+    EXPECT_FALSE(resolved);
+    second.resolve();
+    EXPECT_TRUE(resolved);
+
+    resolved = false;
+    event::when_all().then([&](){ resolved = true; });
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAllRejected){
+    event::Promise<int> first;
+    event::Promise<int> second;
+
+    int rejections = 0;
+    event::when_all(first.future(), second.future()).then([&](std::tuple<int, int>&&){
+        FAIL() << "Entered resolve handler for rejected join.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(5, err.error_code());
+        ++rejections;
+    });
+
+    second.reject(error::Exception(5, "First error"));
+    first.reject(error::Exception(6, "Second error"));
+    EXPECT_EQ(1, rejections);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAllRange){
+    std::vector<event::Promise<int>> promises(10);
+    std::vector<event::Future<int>> futures;
+    for (auto& promise : promises) {
+        futures.push_back(promise.future());
+    }
+
+    std::vector<int> results;
+    event::when_all(futures.begin(), futures.end()).then([&](std::vector<int>&& values){
+        results = std::move(values);
+    });
+
+    for (int i = (int)promises.size() - 1; i >= 0; --i) {
+        EXPECT_TRUE(results.empty());
+        promises[i].resolve(i * 2);
+    }
+    ASSERT_EQ(promises.size(), results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ((int)i * 2, results[i]);
+    }
+
+    futures.clear();
+    bool resolved = false;
+    event::when_all(futures.begin(), futures.end()).then([&](std::vector<int>&& values){
+        EXPECT_TRUE(values.empty());
+        resolved = true;
+    });
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAny){
+    event::Promise<int> first;
+    event::Promise<int> second;
+    event::Promise<int> third;
+
+    int resolutions = 0;
+    event::when_any(first.future(), second.future(), third.future())
+        .then([&](std::pair<std::size_t, int>&& result){
+            EXPECT_EQ(2u, result.first);
+            EXPECT_EQ(30, result.second);
+            ++resolutions;
+        });
+
+    first.reject(error::Exception(1, "Ignored error"));
+    EXPECT_EQ(0, resolutions);
+    third.resolve(30);
+    second.resolve(20);
+    EXPECT_EQ(1, resolutions);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, WhenAnyAllRejected){
+    std::vector<event::Promise<>> promises(3);
+    std::vector<event::Future<>> futures;
+    for (auto& promise : promises) {
+        futures.push_back(promise.future());
+    }
+
+    bool rejected = false;
+    event::when_any(futures.begin(), futures.end()).then([&](std::size_t){
+        FAIL() << "Entered resolve handler for rejected join.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(3, err.error_code());
+        rejected = true;
+    });
+
+    promises[0].reject(error::Exception(1, "First error"));
+    promises[2].reject(error::Exception(2, "Second error"));
+    EXPECT_FALSE(rejected);
+    promises[1].reject(error::Exception(3, "Last error"));
+    EXPECT_TRUE(rejected);
+
+    futures.clear();
+    rejected = false;
+    event::when_any(futures.begin(), futures.end()).then([&](std::size_t){
+        FAIL() << "Entered resolve handler for empty join.";
+    }, [&](const error::Exception&){
+        rejected = true;
+    });
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, Race){
+    event::Promise<int> first;
+    event::Promise<int> second;
+
+    bool rejected = false;
+    event::race(first.future(), second.future()).then([&](std::pair<std::size_t, int>&&){
+        FAIL() << "Entered resolve handler for rejected race.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(9, err.error_code());
+        rejected = true;
+    });
+
+    second.reject(error::Exception(9, "Race error"));
+    EXPECT_TRUE(rejected);
+    first.resolve(1);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(JoinTests, RaceOnLoop){
+    event::Loop loop;
+    event::Timeout slow(loop);
+    event::Timeout fast(loop);
+
+    std::size_t winner = 100;
+    event::race(slow.start(std::chrono::milliseconds(50)), fast.start(std::chrono::milliseconds(5)))
+        .then([&](std::size_t index){ winner = index; });
+
+    loop.run();
+    EXPECT_EQ(1u, winner);
+}
+
+}
+}
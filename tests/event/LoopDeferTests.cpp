@@ -0,0 +1,125 @@
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct LoopDeferTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, DeferRunsOnLoop){
+    bool called = false;
+    loop.defer([&](){ called = true; });
+    EXPECT_FALSE(called);
+
+    loop.run();
+    EXPECT_TRUE(called);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, DeferOrder){
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        loop.defer([&, i](){ order.push_back(i); });
+    }
+
+    loop.run();
+    ASSERT_EQ(100u, order.size());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i, order[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, DeferFromDeferred){
+    int outer_iteration = 0;
+    int inner_iteration = 0;
+    int iteration = 0;
+
+    event::Idle idle(loop);
+    idle.start([&](){ ++iteration; });
+
+    loop.defer([&](){
+        outer_iteration = iteration;
+        loop.defer([&](){
+            inner_iteration = iteration;
+            idle.stop();
+        });
+    });
+
+    loop.run();
+    EXPECT_LT(outer_iteration, inner_iteration);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, MoveOnlyTask){
+    std::unique_ptr<int> value(new int(5));
+    int result = 0;
+    loop.defer([&, value = std::move(value)](){ result = *value; });
+
+    loop.run();
+    EXPECT_EQ(5, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, ManyDeferredResolutions){
+    const int count = 10000;
+    int resolved = 0;
+    for (int i = 0; i < count; ++i) {
+        event::resolve(loop, i).then([&, i](int value){
+            EXPECT_EQ(i, value);
+            ++resolved;
+        });
+    }
+    EXPECT_EQ(0, resolved);
+
+    loop.run();
+    EXPECT_EQ(count, resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, LoopCanRunAgain){
+    int calls = 0;
+    loop.defer([&](){ ++calls; });
+    loop.run();
+    EXPECT_EQ(1, calls);
+
+    loop.defer([&](){ ++calls; });
+    loop.run();
+    EXPECT_EQ(2, calls);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopDeferTests, ThrowingTask){
+    std::vector<char> order;
+    loop.defer([&](){ order.push_back('a'); });
+    loop.defer([&](){
+        order.push_back('b');
+        throw error::Exception(1, "Failed in task.");
+    });
+    loop.defer([&](){ order.push_back('c'); });
+    loop.defer([&](){ order.push_back('l'); }, event::Priority::LOW);
+
+    // The tasks which already ran are not run again, and the rest still run on the next go.
+    EXPECT_THROW(loop.run(), error::Exception);
+    EXPECT_EQ((std::vector<char>{'a', 'b'}), order);
+
+    loop.run();
+    EXPECT_EQ((std::vector<char>{'a', 'b', 'c', 'l'}), order);
+}
+
+}
+}
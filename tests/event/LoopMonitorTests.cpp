@@ -0,0 +1,72 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct LoopMonitorTests : public testing::Test {
+    event::Loop loop;
+
+    /// Keeps the thread busy without giving the loop a chance to run.
+    static void block(const std::chrono::milliseconds duration){
+        const auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopMonitorTests, Unmonitored){
+    event::wait(loop, 1ms);
+    loop.run();
+
+    auto stats = loop.iteration_stats();
+    EXPECT_EQ(0u, stats.iterations);
+    EXPECT_EQ(0ns, stats.poll_time);
+    EXPECT_EQ(0u, stats.callback_phase.count());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopMonitorTests, PollAndCallbacks){
+    loop.monitor_iterations();
+
+    // Monitoring alone does not keep the loop running.
+    loop.run();
+
+    event::wait(loop, 20ms).then([](){ block(20ms); });
+    loop.run();
+
+    auto stats = loop.iteration_stats();
+    EXPECT_LE(1u, stats.iterations);
+    EXPECT_LT(0.0, stats.iterations_per_second);
+    EXPECT_EQ(stats.iterations, stats.callback_phase.count());
+    EXPECT_GE(stats.poll_time, 10ms);
+    EXPECT_GE(stats.callback_time, 20ms);
+    EXPECT_GE(stats.callback_phase.percentile(100), 20ms);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopMonitorTests, Lag){
+    std::vector<std::chrono::nanoseconds> lags;
+    loop.on_lag(15ms, [&](std::chrono::nanoseconds blocked){ lags.push_back(blocked); });
+
+    event::wait(loop, 1ms).then([](){ block(1ms); });
+    event::wait(loop, 5ms).then([](){ block(30ms); });
+    loop.run();
+
+    ASSERT_EQ(1u, lags.size());
+    EXPECT_GE(lags[0], 30ms);
+    EXPECT_LT(lags[0], 1s);
+}
+
+}
+}
@@ -0,0 +1,117 @@
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct LoopPostTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPostTests, FromLoopThread){
+    bool called = false;
+    loop.post([&](){ called = true; });
+    EXPECT_FALSE(called);
+
+    // Nothing keeps the loop running, so the task waits for the next run.
+    loop.run();
+    EXPECT_FALSE(called);
+
+    event::Promise<> promise(loop);
+    loop.post([&](){ promise.resolve(); });
+    loop.run();
+    EXPECT_TRUE(called);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPostTests, ThrowingTask){
+    bool called = false;
+    event::Promise<> promise(loop);
+    std::thread producer([&](){
+        loop.post([](){ throw error::Exception(1, "Failed in task."); });
+        loop.post([&](){
+            called = true;
+            promise.resolve();
+        });
+    });
+    producer.join();
+
+    // The task after the throwing one is kept for the next run.
+    EXPECT_THROW(loop.run(), error::Exception);
+    EXPECT_FALSE(called);
+
+    loop.run();
+    EXPECT_TRUE(called);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPostTests, ManyProducers){
+    const int producers = 4;
+    const int tasks = 50000;
+
+    // Each producer's tasks must run in the order it posted them.
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    std::thread::id loop_thread;
+    bool on_loop = true;
+
+    event::Promise<> done(loop);
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&, producer](){
+            for (int i = 0; i < tasks; ++i) {
+                loop.post([&, producer, i](){
+                    ordered = ordered && next[producer] == i;
+                    on_loop = on_loop && std::this_thread::get_id() == loop_thread;
+                    next[producer] = i + 1;
+                    if (++received == producers * tasks) {
+                        done.resolve();
+                    }
+                });
+            }
+        });
+    }
+
+    loop_thread = std::this_thread::get_id();
+    loop.run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(producers * tasks, received);
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(on_loop);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPostTests, PostDuringShutdown){
+    // Resolving a bound promise posts from the producer, and the loop may run the task, exit and be
+    // destroyed while the producer is still signalling it.
+    for (int i = 0; i < 500; ++i) {
+        std::unique_ptr<event::Loop> other(new event::Loop());
+        bool resolved = false;
+        event::Promise<> promise(*other);
+        promise.future().then([&](){ resolved = true; });
+
+        std::thread producer([&](){ promise.resolve(); });
+        other->run();
+        other.reset();
+        producer.join();
+        EXPECT_TRUE(resolved);
+    }
+}
+
+}
+}
@@ -0,0 +1,129 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct LoopPriorityTests : public testing::Test {
+    event::Loop loop;
+
+    /// Keeps the thread busy without giving the loop a chance to run.
+    static void block(const std::chrono::microseconds duration){
+        const auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPriorityTests, Defer){
+    std::string order;
+    loop.defer([&](){ order += 'l'; }, event::Priority::LOW);
+    loop.defer([&](){ order += 'n'; });
+    loop.defer([&](){ order += 'h'; }, event::Priority::HIGH);
+    loop.defer([&](){ order += 'N'; }, event::Priority::NORMAL);
+
+    EXPECT_FALSE(loop.run_once());
+    EXPECT_EQ("hnNl", order);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPriorityTests, Budget){
+    loop.task_budget(1ms);
+    EXPECT_EQ(1ms, loop.task_budget());
+
+    // A flood of normal work cannot hold up the loop or starve the low lane.
+    int normal = 0;
+    int low = 0;
+    for (int i = 0; i < 10; ++i) {
+        loop.defer([&](){
+            block(500us);
+            ++normal;
+        });
+    }
+    for (int i = 0; i < 3; ++i) {
+        loop.defer([&](){ ++low; }, event::Priority::LOW);
+    }
+
+    EXPECT_TRUE(loop.run_once());
+    EXPECT_LE(1, normal);
+    EXPECT_GE(3, normal);
+    EXPECT_EQ(1, low);
+
+    EXPECT_TRUE(loop.run_once());
+    EXPECT_EQ(2, low);
+
+    loop.run();
+    EXPECT_EQ(10, normal);
+    EXPECT_EQ(3, low);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPriorityTests, Post){
+    std::string order;
+    loop.post([&](){ order += 'l'; }, event::Priority::LOW);
+    loop.post([&](){ order += 'n'; });
+    loop.post([&](){ order += 'h'; }, event::Priority::HIGH);
+
+    // Posted tasks without a priority run as soon as they arrive, the rest go into the lanes.
+    event::wait(loop, 1ms);
+    loop.run();
+    EXPECT_EQ("nhl", order);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPriorityTests, Then){
+    std::string order;
+    event::Promise<int> low;
+    event::Promise<> high;
+    const event::Priority priority = event::Priority::HIGH;
+
+    low.future().then(event::Priority::LOW, [&](int value){
+        order += 'l';
+        return value * 2;
+    }).then([&](int value){
+        EXPECT_EQ(42, value);
+        order += 'L';
+    });
+    high.future().then(priority, [&](){ order += 'h'; });
+
+    low.resolve(21);
+    high.resolve();
+    EXPECT_TRUE(order.empty());
+
+    loop.run();
+    EXPECT_EQ("hlL", order);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopPriorityTests, ThenRejected){
+    bool ran = false;
+    bool rejected = false;
+    event::Promise<> promise;
+    promise.future().then(event::Priority::LOW, [&](){
+        ran = true;
+    }).then([](){
+        FAIL() << "Entered resolve handler for rejected future.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(3, err.error_code());
+        rejected = true;
+    });
+
+    promise.reject(error::Exception(3, "Rejected."));
+    loop.run();
+    EXPECT_FALSE(ran);
+    EXPECT_TRUE(rejected);
+}
+
+}
+}
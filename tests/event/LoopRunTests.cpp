@@ -0,0 +1,106 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct LoopRunTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopRunTests, RunNowait){
+    EXPECT_FALSE(loop.run_nowait());
+
+    bool waited = false;
+    event::wait(loop, 20ms).then([&](){ waited = true; });
+
+    // Returns straight away while the timer is still pending.
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(loop.run_nowait());
+    EXPECT_FALSE(waited);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 10ms);
+
+    loop.run();
+    EXPECT_TRUE(waited);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopRunTests, RunOnce){
+    int deferred = 0;
+    loop.defer([&](){
+        ++deferred;
+        loop.defer([&](){ ++deferred; });
+    });
+
+    // Each iteration runs the tasks deferred before it started.
+    EXPECT_TRUE(loop.run_once());
+    EXPECT_EQ(1, deferred);
+    EXPECT_FALSE(loop.run_once());
+    EXPECT_EQ(2, deferred);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopRunTests, RunFor){
+    bool waited = false;
+    event::wait(loop, 200ms).then([&](){ waited = true; });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(loop.run_for(10ms));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_FALSE(waited);
+    EXPECT_GE(elapsed, 10ms);
+    EXPECT_LT(elapsed, 150ms);
+
+    // The limit does not keep an idle loop running.
+    loop.run();
+    EXPECT_TRUE(waited);
+    EXPECT_FALSE(loop.run_for(1s));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopRunTests, RunUntil){
+    event::Promise<int> promise(loop);
+    auto future = promise.future();
+    bool other = false;
+    event::wait(loop, 200ms).then([&](){ other = true; });
+
+    std::thread worker([&](){
+        std::this_thread::sleep_for(5ms);
+        promise.resolve(7);
+    });
+    EXPECT_TRUE(loop.run_until(future));
+    worker.join();
+    EXPECT_FALSE(other);
+
+    int result = 0;
+    future.then([&](int value){ result = value; });
+    EXPECT_EQ(7, result);
+
+    loop.run();
+    EXPECT_TRUE(other);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopRunTests, RunUntilNoWork){
+    event::Promise<> promise;
+    auto future = promise.future();
+    EXPECT_FALSE(loop.run_until(future));
+
+    promise.resolve();
+    EXPECT_TRUE(loop.run_until(future));
+}
+
+}
+}
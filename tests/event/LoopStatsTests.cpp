@@ -0,0 +1,91 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct LoopStatsTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopStatsTests, Histogram){
+    event::LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.count());
+    EXPECT_EQ(0ns, histogram.percentile(50));
+
+    histogram.record(0ns);
+    histogram.record(100ns);
+    histogram.record(100ns);
+    histogram.record(1s);
+    EXPECT_EQ(4, histogram.count());
+    EXPECT_EQ(1, histogram.bucket(0));
+    EXPECT_EQ(2, histogram.bucket(6));
+    EXPECT_EQ(1, histogram.bucket(29));
+    EXPECT_EQ(128ns, histogram.percentile(50));
+    EXPECT_GE(histogram.percentile(100), 1s);
+
+    histogram.record(1000s);
+    EXPECT_EQ(1, histogram.bucket(event::LatencyHistogram::bucket_count - 1));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+#ifdef LW_ENABLE_EVENT_STATS
+
+TEST_F(LoopStatsTests, Counts){
+    {
+        event::Promise<int> promise;
+        auto future = promise.future()
+            .then([](int value){ return value + 1; })
+            .then([](int value){ return value + 1; });
+        EXPECT_EQ(3, loop.stats().live_states);
+
+        promise.resolve(1);
+        EXPECT_EQ(2, loop.stats().max_chain_depth);
+    }
+
+    auto stats = loop.stats();
+    EXPECT_EQ(0, stats.live_states);
+    EXPECT_EQ(3, stats.states_created);
+    EXPECT_LT(0.0, stats.allocations_per_second);
+    EXPECT_EQ(2, stats.resolve_latency.count());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopStatsTests, UnresolvedAtExit){
+    event::Promise<> never;
+    event::Promise<> later;
+    never.future().then([](){});
+    later.future().then([](){});
+    event::wait(loop, 1ms).then([&](){ later.resolve(); });
+
+    loop.run();
+    EXPECT_EQ(2, loop.stats().unresolved_at_exit);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopStatsTests, CurrentLoop){
+    {
+        event::Loop inner;
+        event::Promise<> promise;
+        EXPECT_EQ(1, inner.stats().live_states);
+        EXPECT_EQ(0, loop.stats().live_states);
+    }
+
+    event::Promise<> promise;
+    EXPECT_EQ(1, loop.stats().live_states);
+}
+
+#endif
+
+}
+}
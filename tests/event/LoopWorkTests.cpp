@@ -0,0 +1,105 @@
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct LoopWorkTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopWorkTests, Value){
+    std::thread::id work_thread;
+    std::thread::id continuation_thread;
+    std::string result;
+    loop.queue_work([&](){
+        work_thread = std::this_thread::get_id();
+        return std::string("done");
+    }).then([&](std::string&& value){
+        continuation_thread = std::this_thread::get_id();
+        result = std::move(value);
+    });
+    EXPECT_TRUE(result.empty());
+
+    loop.run();
+    EXPECT_EQ("done", result);
+    EXPECT_NE(std::this_thread::get_id(), work_thread);
+    EXPECT_EQ(std::this_thread::get_id(), continuation_thread);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopWorkTests, Void){
+    std::atomic<int> calls(0);
+    int resolved = 0;
+    for (int i = 0; i < 8; ++i) {
+        loop.queue_work([&](){ ++calls; }).then([&](){ ++resolved; });
+    }
+
+    loop.run();
+    EXPECT_EQ(8, calls.load());
+    EXPECT_EQ(8, resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopWorkTests, Exception){
+    bool rejected = false;
+    loop.queue_work([]() -> int {
+        throw error::Exception(3, "Work failed.");
+    }).then([](int){
+        FAIL() << "Entered resolve handler for failed work.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(3, err.error_code());
+        EXPECT_STREQ("Work failed.", err.what());
+        rejected = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopWorkTests, ForeignException){
+    bool rejected = false;
+    loop.queue_work([]() -> int {
+        throw std::runtime_error("Parse failed.");
+    }).then([](int){
+        FAIL() << "Entered resolve handler for failed work.";
+    }, [&](const error::Error& err){
+        EXPECT_EQ("Parse failed.", err.message());
+        EXPECT_THROW(err.raise(), std::runtime_error);
+        rejected = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(LoopWorkTests, MoveOnly){
+    std::unique_ptr<int> input(new int(20));
+    int result = 0;
+    loop.queue_work([input = std::move(input)](){
+        return std::unique_ptr<int>(new int(*input + 1));
+    }).then([&](std::unique_ptr<int>&& value){
+        result = *value;
+    });
+
+    loop.run();
+    EXPECT_EQ(21, result);
+}
+
+}
+}
@@ -0,0 +1,147 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct PreciseTimeoutTests : public testing::Test {
+    typedef steady_clock clock;
+
+    static const microseconds max_discrepancy;
+
+    event::Loop loop;
+};
+
+const microseconds PreciseTimeoutTests::max_discrepancy = 500us;
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, ShortDelay){
+    bool resolved = false;
+    const auto start = clock::now();
+    event::wait_precisely(loop, 200us).then([&](){
+        const auto time_passed = clock::now() - start;
+        EXPECT_GE(time_passed, 200us);
+        EXPECT_LE(time_passed, 200us + max_discrepancy);
+        resolved = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, WaitUntil){
+    bool resolved = false;
+    const auto when = clock::now() + 1500us;
+    event::wait_until_precisely(loop, when).then([&](){
+        EXPECT_GE(clock::now(), when);
+        EXPECT_LE(clock::now(), when + max_discrepancy);
+        resolved = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, Repeat){
+    int call_count = 0;
+    bool resolved = false;
+    const auto start = clock::now();
+    event::PreciseTimeout timeout(loop);
+    timeout.repeat(100us, [&](event::PreciseTimeout& repeat_timeout){
+        ++call_count;
+        EXPECT_GE(clock::now() - start, 100us * call_count);
+        if (call_count == 5) {
+            repeat_timeout.stop();
+        }
+    }).then([&](){ resolved = true; });
+
+    loop.run();
+    EXPECT_EQ(5, call_count);
+    EXPECT_TRUE(resolved);
+    EXPECT_LE(clock::now() - start, 500us + max_discrepancy);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, Stop){
+    bool rejected = false;
+    event::PreciseTimeout timeout(loop);
+    timeout.start(1ms).then([](){
+        FAIL() << "Entered resolve handler for stopped timeout.";
+    }, [&](const error::Exception& err){
+        EXPECT_NE(nullptr, dynamic_cast<const event::TimeoutError*>(&err));
+        rejected = true;
+    });
+    timeout.stop();
+    EXPECT_TRUE(rejected);
+
+    // The same timeout can be started again.
+    bool resolved = false;
+    timeout.start(100us).then([&](){ resolved = true; });
+    loop.run();
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, StopAfterFire){
+    int resolved = 0;
+    event::PreciseTimeout timeout(loop);
+    timeout.start(100us).then([&](){ ++resolved; });
+    loop.run();
+    EXPECT_EQ(1, resolved);
+
+    // Stopping a timeout which already fired does nothing.
+    timeout.stop();
+    timeout.start(100us).then([&](){ ++resolved; });
+    loop.run();
+    EXPECT_EQ(2, resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, Cancel){
+    event::CancellationSource source;
+    bool cancelled = false;
+    event::wait_precisely(loop, 1s, source.token()).then([](){
+        FAIL() << "Entered resolve handler for cancelled timeout.";
+    }, [&](const error::Exception& err){
+        EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+        cancelled = true;
+    });
+
+    event::wait_precisely(loop, 100us).then([&](){ source.cancel(); });
+    const auto start = clock::now();
+    loop.run();
+    EXPECT_TRUE(cancelled);
+    EXPECT_LE(clock::now() - start, 100us + max_discrepancy);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PreciseTimeoutTests, Unref){
+    bool fired = false;
+    event::PreciseTimeout background(loop);
+    background.start(1s).then([&](){ fired = true; }, [](const error::Exception&){});
+    background.unref();
+
+    const auto start = clock::now();
+    loop.run();
+    EXPECT_FALSE(fired);
+    EXPECT_LE(clock::now() - start, max_discrepancy);
+    background.stop();
+}
+
+}
+}
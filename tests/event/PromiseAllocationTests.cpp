@@ -0,0 +1,114 @@
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+
+#include "lw/event.hpp"
+
+// Replacing the global allocation functions affects the whole program, so these tests are built
+// into their own `liblw-allocation-tests` binary. Only allocations made by the test's own thread
+// while counting is switched on are counted.
+
+namespace {
+    thread_local bool count_allocations         = false;
+    thread_local std::size_t allocation_count   = 0;
+}
+
+void* operator new(std::size_t size){
+    if (count_allocations) {
+        ++allocation_count;
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace lw {
+namespace tests {
+
+struct PromiseAllocationTests : public testing::Test {
+    /// @brief Builds and resolves a three step chain, returning the final value.
+    int run_chain(const int value){
+        int result = 0;
+        event::Promise<int> promise;
+        promise.future()
+            .then([&](int v){ return v + 1; })
+            .then<int>([&](int v, event::Promise<int>&& next){ next.resolve(v * 2); })
+            .then([&](int v){ result = v; });
+        promise.resolve(value);
+        return result;
+    }
+
+    void SetUp(void){
+        allocation_count = 0;
+        count_allocations = false;
+    }
+
+    void TearDown(void){
+        count_allocations = false;
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseAllocationTests, ChainIsAllocationFreeWhenWarm){
+    // First run fills the free lists.
+    EXPECT_EQ(6, run_chain(2));
+
+    count_allocations = true;
+    const int result = run_chain(3);
+    count_allocations = false;
+
+    EXPECT_EQ(8, result);
+    EXPECT_EQ(0u, allocation_count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseAllocationTests, ForwardingIsAllocationFreeWhenWarm){
+    auto forward = [](){
+        event::Promise<> source;
+        event::Promise<> target;
+        bool resolved = false;
+        target.future().then([&](){ resolved = true; });
+        source.future().then(std::move(target));
+        source.resolve();
+        return resolved;
+    };
+    EXPECT_TRUE(forward());
+
+    count_allocations = true;
+    const bool resolved = forward();
+    count_allocations = false;
+
+    EXPECT_TRUE(resolved);
+    EXPECT_EQ(0u, allocation_count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseAllocationTests, LargeHandlersStillWork){
+    struct Large {
+        char bytes[256];
+    };
+    Large large;
+    large.bytes[0] = 42;
+
+    int result = 0;
+    event::Promise<int> promise;
+    promise.future().then([&, large](int v){ result = v + large.bytes[0]; });
+    promise.resolve(1);
+    EXPECT_EQ(43, result);
+}
+
+}
+}
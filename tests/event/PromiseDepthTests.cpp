@@ -0,0 +1,85 @@
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct PromiseDepthTests : public testing::Test {
+    /// Enough links to overflow the stack if each one recursed into the next.
+    static constexpr int links = 500000;
+
+    static event::Future<int> ready(const int value){
+        event::Promise<int> promise;
+        promise.resolve(value);
+        return promise.future();
+    }
+
+    static event::Future<int> count_up(const int value){
+        return ready(value).then([](int value){
+            return value == links ? ready(value) : count_up(value + 1);
+        });
+    }
+};
+
+constexpr int PromiseDepthTests::links;
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseDepthTests, LongPendingChain){
+    event::Promise<int> promise;
+    event::Future<int> future = promise.future();
+    for (int i = 0; i < links; ++i) {
+        future = future.then([](int value){ return value + 1; });
+    }
+
+    int result = 0;
+    future.then([&](int value){ result = value; });
+    promise.resolve(0);
+    EXPECT_EQ(links, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseDepthTests, LongRejectedChain){
+    event::Promise<> promise;
+    event::Future<> future = promise.future();
+    for (int i = 0; i < links; ++i) {
+        future = future.then([](){ FAIL() << "Entered resolve handler for rejected chain."; });
+    }
+
+    bool rejected = false;
+    future.then([](){}, [&](const error::Exception& err){
+        EXPECT_EQ(42, err.error_code());
+        rejected = true;
+    });
+    promise.reject(error::Exception(42, "Rejected."));
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseDepthTests, RecursiveReadyLoop){
+    int result = 0;
+    count_up(0).then([&](int value){ result = value; });
+    EXPECT_EQ(links, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseDepthTests, ShallowChainRunsInOrder){
+    event::Promise<> promise;
+    std::vector<int> order;
+    auto future = promise.future();
+    for (int i = 0; i < 3; ++i) {
+        future = future.then([&order, i](){ order.push_back(i); });
+    }
+    promise.resolve();
+    order.push_back(3);
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), order);
+}
+
+}
+}
@@ -0,0 +1,136 @@
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct PromiseReadyTests : public testing::Test {
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, ResolveBeforeThen){
+    event::Promise<int> promise;
+    promise.resolve(42);
+
+    bool resolved = false;
+    promise.future().then([&](int value){
+        EXPECT_EQ(42, value);
+        resolved = true;
+    });
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, ResolveVoidBeforeThen){
+    event::Promise<> promise;
+    auto future = promise.future();
+    promise.resolve();
+
+    bool resolved = false;
+    future.then([&](){ resolved = true; });
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, ReadyChainRunsSynchronously){
+    event::Promise<int> promise;
+    promise.resolve(1);
+
+    int result = 0;
+    promise.future()
+        .then([](int value){ return value + 1; })
+        .then([](int value){
+            event::Promise<int> inner;
+            inner.resolve(value * 10);
+            return inner.future();
+        })
+        .then([&](int value){ result = value; });
+    EXPECT_EQ(20, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, MoveOnlyValue){
+    event::Promise<std::unique_ptr<int>> promise;
+    promise.resolve(std::unique_ptr<int>(new int(7)));
+
+    int result = 0;
+    promise.future().then([&](std::unique_ptr<int>&& value){ result = *value; });
+    EXPECT_EQ(7, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, RejectBeforeThen){
+    event::Promise<int> promise;
+    promise.reject(error::Exception(12, "Early error"));
+
+    bool rejected = false;
+    promise.future().then([&](int){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(12, err.error_code());
+        EXPECT_EQ((std::string)"Early error", err.what());
+        rejected = true;
+    });
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, RejectHeldFutureBeforeThen){
+    event::Promise<> promise;
+    auto future = promise.future();
+    EXPECT_NO_THROW(promise.reject(error::Exception(3, "Held error")));
+
+    bool rejected = false;
+    future.then([&](){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }).then([&](){
+        FAIL() << "Entered resolve handler after rejected promise.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(3, err.error_code());
+        rejected = true;
+    });
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, HeldValueReleasedWithState){
+    auto value = std::make_shared<int>(5);
+    std::weak_ptr<int> watcher = value;
+    {
+        event::Promise<std::shared_ptr<int>> promise;
+        promise.resolve(std::move(value));
+        EXPECT_FALSE(watcher.expired());
+    }
+    EXPECT_TRUE(watcher.expired());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseReadyTests, ResetReleasesHeldValue){
+    auto value = std::make_shared<int>(5);
+    std::weak_ptr<int> watcher = value;
+
+    event::Promise<std::shared_ptr<int>> promise;
+    promise.resolve(std::move(value));
+    promise.reset();
+    EXPECT_TRUE(watcher.expired());
+
+    bool resolved = false;
+    promise.future().then([&](std::shared_ptr<int>&&){ resolved = true; });
+    EXPECT_FALSE(resolved);
+    promise.resolve(std::make_shared<int>(6));
+    EXPECT_TRUE(resolved);
+}
+
+}
+}
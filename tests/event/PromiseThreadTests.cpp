@@ -0,0 +1,122 @@
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct PromiseThreadTests : public testing::Test {
+    event::Loop loop;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseThreadTests, ResolveFromThread){
+    event::Promise<int> promise(loop);
+    std::thread::id continuation_thread;
+    int result = 0;
+    promise.future().then([&](int value){
+        continuation_thread = std::this_thread::get_id();
+        result = value;
+    });
+
+    std::thread worker([&](){
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        promise.resolve(42);
+    });
+
+    loop.run();
+    worker.join();
+    EXPECT_EQ(42, result);
+    EXPECT_EQ(std::this_thread::get_id(), continuation_thread);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseThreadTests, RejectFromThread){
+    event::Promise<> promise(loop);
+    bool rejected = false;
+    promise.future().then([&](){
+        FAIL() << "Entered resolve handler for rejected promise.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(7, err.error_code());
+        rejected = true;
+    });
+
+    std::thread worker([&](){ promise.reject(error::Exception(7, "Worker error")); });
+
+    loop.run();
+    worker.join();
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseThreadTests, ManyProducers){
+    const int thread_count = 4;
+    const int per_thread = 2000;
+
+    std::vector<event::Promise<int>> promises;
+    for (int i = 0; i < thread_count * per_thread; ++i) {
+        promises.emplace_back(loop);
+    }
+
+    int sum = 0;
+    int resolved = 0;
+    for (auto& promise : promises) {
+        promise.future().then([&](int value){
+            sum += value;
+            ++resolved;
+        });
+    }
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&, t](){
+            for (int i = 0; i < per_thread; ++i) {
+                promises[t * per_thread + i].resolve(1);
+            }
+        });
+    }
+
+    loop.run();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(thread_count * per_thread, resolved);
+    EXPECT_EQ(thread_count * per_thread, sum);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseThreadTests, DroppedOnThreadReleasesLoop){
+    {
+        event::Promise<> promise(loop);
+        std::thread worker([promise = std::move(promise)]() mutable {
+            event::Promise<> dropped = std::move(promise);
+        });
+        worker.join();
+    }
+
+    // Would block forever if the dropped promise still held the loop.
+    loop.run();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(PromiseThreadTests, ResolveOnLoopThreadIsSynchronous){
+    event::Promise<int> promise(loop);
+    int result = 0;
+    promise.future().then([&](int value){ result = value; });
+    promise.resolve(3);
+    EXPECT_EQ(3, result);
+
+    loop.run();
+}
+
+}
+}
@@ -0,0 +1,147 @@
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct SharedFutureTests : public testing::Test {
+    /// A value which counts how many times it is copied.
+    struct Counted {
+        Counted(int* copies):
+            copies(copies)
+        {}
+
+        Counted(const Counted& other):
+            copies(other.copies)
+        {
+            ++*copies;
+        }
+
+        Counted(Counted&& other) = default;
+
+        int* copies;
+    };
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(SharedFutureTests, ManyConsumers){
+    int copies = 0;
+    int calls = 0;
+    event::Promise<Counted> promise;
+    event::SharedFuture<Counted> shared = promise.future().share();
+
+    const Counted* first = nullptr;
+    for (int i = 0; i < 100; ++i) {
+        shared.then([&](const Counted& value){
+            if (!first) {
+                first = &value;
+            }
+            EXPECT_EQ(first, &value);
+            ++calls;
+        });
+    }
+    EXPECT_FALSE(shared.is_ready());
+    EXPECT_EQ(0, calls);
+
+    promise.resolve(Counted(&copies));
+    EXPECT_TRUE(shared.is_ready());
+    EXPECT_EQ(100, calls);
+
+    event::SharedFuture<Counted> copy = shared;
+    copy.then([&](const Counted& value){
+        EXPECT_EQ(first, &value);
+        ++calls;
+    });
+    EXPECT_EQ(101, calls);
+    EXPECT_EQ(0, copies);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(SharedFutureTests, Chaining){
+    event::Promise<std::string> promise;
+    auto shared = promise.future().share();
+
+    std::size_t length = 0;
+    std::string upper;
+    shared.then([](const std::string& value){ return value.size(); })
+        .then([&](std::size_t size){ length = size; });
+    shared.then([](const std::string& value){
+        event::Promise<std::string> inner;
+        inner.resolve(value + "!");
+        return inner.future();
+    }).then([&](std::string&& value){ upper = std::move(value); });
+
+    promise.resolve("hello");
+    EXPECT_EQ(5, length);
+    EXPECT_EQ("hello!", upper);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(SharedFutureTests, Rejected){
+    event::Promise<int> promise;
+    auto shared = promise.future().share();
+
+    int rejections = 0;
+    for (int i = 0; i < 3; ++i) {
+        shared.then([](const int&){
+            FAIL() << "Entered resolve handler for rejected shared future.";
+        }, [&](const error::Exception& err){
+            EXPECT_EQ(9, err.error_code());
+            ++rejections;
+        });
+    }
+
+    promise.reject(error::Exception(9, "Rejected."));
+    EXPECT_EQ(3, rejections);
+
+    shared.then([](const int&){}, [&](const error::Error& err){
+        EXPECT_EQ(9, err.code());
+        ++rejections;
+    });
+    EXPECT_EQ(4, rejections);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(SharedFutureTests, DroppedConsumer){
+    event::Promise<int> promise;
+    auto shared = promise.future().share();
+
+    // The first consumer has no reject handler and drops its future, so its rejection is raised.
+    shared.then([](const int&){
+        FAIL() << "Entered resolve handler for rejected shared future.";
+    });
+
+    bool rejected = false;
+    shared.then([](const int&){
+        FAIL() << "Entered resolve handler for rejected shared future.";
+    }, [&](const error::Exception& err){
+        EXPECT_EQ(9, err.error_code());
+        rejected = true;
+    });
+
+    EXPECT_THROW(promise.reject(error::Exception(9, "Rejected.")), error::Exception);
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(SharedFutureTests, Void){
+    event::Promise<> promise;
+    auto shared = promise.future().share();
+
+    int calls = 0;
+    shared.then([&](){ ++calls; });
+    shared.then([&](){ ++calls; });
+    promise.resolve();
+    EXPECT_EQ(2, calls);
+}
+
+}
+}
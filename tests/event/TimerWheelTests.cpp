@@ -0,0 +1,176 @@
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "lw/event.hpp"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace lw {
+namespace tests {
+
+struct TimerWheelTests : public testing::Test {
+    typedef steady_clock clock;
+
+    static const milliseconds max_discrepancy;
+
+    /// Counts how many times the wheel expires it.
+    struct CountingNode : public event::TimerWheel::Node {
+        int expired = 0;
+
+        void expire(void) override {
+            ++expired;
+        }
+    };
+
+    TimerWheelTests(void){
+        loop.use_timer_wheel();
+    }
+
+    event::Loop loop;
+};
+
+const milliseconds TimerWheelTests::max_discrepancy = 3ms;
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(TimerWheelTests, Nodes){
+    event::TimerWheel& wheel = *loop.timer_wheel();
+    CountingNode first;
+    CountingNode second;
+    CountingNode cancelled;
+
+    wheel.arm(first, 5ms);
+    wheel.arm(second, 20ms);
+    wheel.arm(second, 10ms); // Re-arming moves the node.
+    wheel.arm(cancelled, 1ms);
+    EXPECT_TRUE(cancelled.is_armed());
+    EXPECT_EQ(3u, wheel.size());
+
+    wheel.cancel(cancelled);
+    wheel.cancel(cancelled);
+    EXPECT_FALSE(cancelled.is_armed());
+    EXPECT_EQ(2u, wheel.size());
+
+    loop.run();
+    EXPECT_EQ(1, first.expired);
+    EXPECT_EQ(1, second.expired);
+    EXPECT_EQ(0, cancelled.expired);
+    EXPECT_FALSE(first.is_armed());
+    EXPECT_EQ(0u, wheel.size());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(TimerWheelTests, Wait){
+    std::string order;
+    const auto start = clock::now();
+    event::wait(loop, 15ms).then([&](){
+        EXPECT_GE(clock::now() - start, 15ms - max_discrepancy);
+        order += 'c';
+    });
+    event::wait(loop, 5ms).then([&](){ order += 'a'; });
+    event::wait(loop, 10ms).then([&](){ order += 'b'; });
+    EXPECT_EQ(3u, loop.timer_wheel()->size());
+
+    loop.run();
+    EXPECT_EQ("abc", order);
+    EXPECT_LE(clock::now() - start, 15ms + max_discrepancy);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(TimerWheelTests, FarTimer){
+    // Further than a turn of the first wheel, so the timer is cascaded down before it fires.
+    const auto start = clock::now();
+    bool resolved = false;
+    event::wait(loop, 300ms).then([&](){
+        const auto time_passed = clock::now() - start;
+        EXPECT_GE(time_passed, 300ms - max_discrepancy);
+        EXPECT_LE(time_passed, 300ms + max_discrepancy);
+        resolved = true;
+    });
+
+    loop.run();
+    EXPECT_TRUE(resolved);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(TimerWheelTests, Cancel){
+    event::CancellationSource source;
+    int resolved = 0;
+    int cancelled = 0;
+    std::vector<event::Future<>> waits;
+    for (int i = 0; i < 10000; ++i) {
+        event::wait(loop, 1h, source.token()).then([&](){
+            ++resolved;
+        }, [&](const error::Exception& err){
+            EXPECT_NE(nullptr, dynamic_cast<const event::CancelledError*>(&err));
+            ++cancelled;
+        });
+    }
+    event::wait(loop, 1ms, source.token()).then([&](){ ++resolved; });
+    EXPECT_EQ(10001u, loop.timer_wheel()->size());
+
+    loop.run_once();
+    source.cancel();
+    EXPECT_EQ(0u, loop.timer_wheel()->size());
+
+    const auto start = clock::now();
+    loop.run();
+    EXPECT_LE(clock::now() - start, max_discrepancy);
+    EXPECT_EQ(1, resolved);
+    EXPECT_EQ(10000, cancelled);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(TimerWheelTests, Timeout){
+    int call_count = 0;
+    bool resolved = false;
+    event::Timeout timeout(loop);
+    timeout.repeat(2ms, [&](event::Timeout& repeat_timeout){
+        if (++call_count == 3) {
+            repeat_timeout.stop();
+        }
+    }).then([&](){ resolved = true; });
+
+    bool rejected = false;
+    event::Timeout stopped(loop);
+    stopped.start(10ms).then([](){
+        FAIL() << "Entered resolve handler for stopped timeout.";
+    }, [&](const error::Exception&){
+        rejected = true;
+    });
+    stopped.stop();
+
+    loop.run();
+    EXPECT_EQ(3, call_count);
+    EXPECT_TRUE(resolved);
+    EXPECT_TRUE(rejected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(TimerWheelTests, Unref){
+    bool fired = false;
+    event::Timeout background(loop);
+    background.start(1h).then([&](){ fired = true; });
+    background.unref();
+
+    // Only the referenced timer keeps the loop running.
+    bool resolved = false;
+    event::wait(loop, 5ms).then([&](){ resolved = true; });
+    const auto start = clock::now();
+    loop.run();
+    EXPECT_TRUE(resolved);
+    EXPECT_FALSE(fired);
+    EXPECT_LE(clock::now() - start, 5ms + max_discrepancy);
+}
+
+}
+}
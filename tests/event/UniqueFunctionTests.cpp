@@ -0,0 +1,117 @@
+
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "lw/event.hpp"
+
+namespace lw {
+namespace tests {
+
+struct UniqueFunctionTests : public testing::Test {
+    /// @brief Records where the functor lives when called.
+    template<std::size_t Size>
+    struct Locator {
+        const void* operator()(void){
+            return this;
+        }
+
+        std::array<char, Size> padding;
+    };
+
+    template<typename Func>
+    static bool is_within(const Func& func, const void* ptr){
+        const char* begin = reinterpret_cast<const char*>(&func);
+        const char* location = static_cast<const char*>(ptr);
+        return location >= begin && location < begin + sizeof(Func);
+    }
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, Empty){
+    event::UniqueFunction<void(void)> func;
+    EXPECT_FALSE(func);
+    EXPECT_TRUE(func == nullptr);
+
+    func = [](){};
+    EXPECT_TRUE(func);
+    EXPECT_TRUE(func != nullptr);
+
+    func = nullptr;
+    EXPECT_FALSE(func);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, ArgumentsAndResult){
+    event::UniqueFunction<std::string(const std::string&, int)> func =
+        [](const std::string& str, int count){
+            std::string result;
+            for (int i = 0; i < count; ++i) {
+                result += str;
+            }
+            return result;
+        };
+    EXPECT_EQ("ababab", func("ab", 3));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, MoveOnlyCapture){
+    std::unique_ptr<int> value(new int(5));
+    event::UniqueFunction<int(void)> func = [value = std::move(value)](){ return *value; };
+    event::UniqueFunction<int(void)> moved = std::move(func);
+    EXPECT_FALSE(func);
+    EXPECT_EQ(5, moved());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, SmallFunctorsInline){
+    event::UniqueFunction<const void*(void), 32> func = Locator<24>();
+    EXPECT_TRUE(is_within(func, func()));
+
+    auto moved = std::move(func);
+    EXPECT_TRUE(is_within(moved, moved()));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, LargeFunctorsBoxed){
+    event::UniqueFunction<const void*(void), 32> func = Locator<64>();
+    const void* location = func();
+    EXPECT_FALSE(is_within(func, location));
+
+    // Boxed functors are moved by pointer.
+    auto moved = std::move(func);
+    EXPECT_EQ(location, moved());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, ReleasesCaptures){
+    auto value = std::make_shared<int>(1);
+    std::weak_ptr<int> watcher = value;
+
+    event::UniqueFunction<void(void)> func = [value = std::move(value)](){};
+    EXPECT_FALSE(watcher.expired());
+
+    func = [](){};
+    EXPECT_TRUE(watcher.expired());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(UniqueFunctionTests, OnlyWrapsCallables){
+    typedef event::UniqueFunction<void(int)> func_type;
+    EXPECT_TRUE((std::is_convertible<void(*)(int), func_type>::value));
+    EXPECT_FALSE((std::is_convertible<int, func_type>::value));
+    EXPECT_FALSE((std::is_convertible<void(*)(std::string), func_type>::value));
+    EXPECT_FALSE(std::is_copy_constructible<func_type>::value);
+}
+
+}
+}
@@ -0,0 +1,49 @@
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "lw/memory.hpp"
+
+namespace lw {
+namespace tests {
+
+struct FreeListTests : public testing::Test {
+    struct Small {
+        char byte;
+    };
+
+#ifdef __cpp_aligned_new
+    struct alignas(128) Wide {
+        char byte;
+    };
+#endif
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+TEST_F(FreeListTests, Recycles){
+    void* first = memory::FreeList<Small>::allocate();
+    memory::FreeList<Small>::deallocate(first);
+
+    void* second = memory::FreeList<Small>::allocate();
+    EXPECT_EQ(first, second);
+    memory::FreeList<Small>::deallocate(second);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+#ifdef __cpp_aligned_new
+TEST_F(FreeListTests, OverAligned){
+    void* blocks[4];
+    for (void*& block : blocks) {
+        block = memory::FreeList<Wide>::allocate();
+        EXPECT_EQ(0u, (std::uintptr_t)block % alignof(Wide));
+    }
+    for (void* block : blocks) {
+        memory::FreeList<Wide>::deallocate(block);
+    }
+}
+#endif
+
+}
+}